@@ -189,6 +189,7 @@ DECLARE_TYPE(TimeZoneTransition,
 /* TimeZone */
 
 static PyObject *t_timezone_getOffset(t_timezone *self, PyObject *args);
+static PyObject *t_timezone_getOffsets(t_timezone *self, PyObject *args);
 static PyObject *t_timezone_getRawOffset(t_timezone *self);
 static PyObject *t_timezone_setRawOffset(t_timezone *self, PyObject *arg);
 static PyObject *t_timezone_getID(t_timezone *self, PyObject *args);
@@ -214,6 +215,7 @@ static PyObject *t_timezone_setDefault(PyTypeObject *type, PyObject *arg);
 
 static PyMethodDef t_timezone_methods[] = {
     DECLARE_METHOD(t_timezone, getOffset, METH_VARARGS),
+    DECLARE_METHOD(t_timezone, getOffsets, METH_VARARGS),
     DECLARE_METHOD(t_timezone, getRawOffset, METH_NOARGS),
     DECLARE_METHOD(t_timezone, setRawOffset, METH_O),
     DECLARE_METHOD(t_timezone, getID, METH_VARARGS),
@@ -237,13 +239,29 @@ static PyMethodDef t_timezone_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
-DECLARE_TYPE(TimeZone, t_timezone, UObject, TimeZone, abstract_init, NULL)
+static void t_timezone_dealloc(t_timezone *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+
+    delete self->transitions;
+    self->transitions = NULL;
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+DECLARE_TYPE(TimeZone, t_timezone, UObject, TimeZone, abstract_init,
+             t_timezone_dealloc)
 
 /* BasicTimeZone */
 
 class t_basictimezone : public _wrapper {
 public:
     BasicTimeZone *object;
+    ObjectLock lock;
+    TransitionTable *transitions;
 };
 
 static PyObject *t_basictimezone_getNextTransition(t_basictimezone *self, PyObject *args);
@@ -280,6 +298,8 @@ DECLARE_TYPE(BasicTimeZone, t_basictimezone, TimeZone, BasicTimeZone,
 class t_rulebasedtimezone : public _wrapper {
 public:
     RuleBasedTimeZone *object;
+    ObjectLock lock;
+    TransitionTable *transitions;
 };
 
 static PyMethodDef t_rulebasedtimezone_methods[] = {
@@ -296,6 +316,8 @@ DECLARE_TYPE(RuleBasedTimeZone,
 class t_simpletimezone : public _wrapper {
 public:
     SimpleTimeZone *object;
+    ObjectLock lock;
+    TransitionTable *transitions;
 };
 
 static int t_simpletimezone_init(t_simpletimezone *self,
@@ -329,6 +351,8 @@ DECLARE_TYPE(SimpleTimeZone, t_simpletimezone, BasicTimeZone, SimpleTimeZone,
 class t_vtimezone : public _wrapper {
 public:
     VTimeZone *object;
+    ObjectLock lock;
+    TransitionTable *transitions;
 };
 
 static PyObject *t_vtimezone_getTZURL(t_vtimezone *self);
@@ -894,6 +918,136 @@ PyObject *wrap_TimeZone(const TimeZone &tz)
     return wrap_TimeZone(tz.clone());
 }
 
+
+/* TransitionTable */
+
+TransitionTable::TransitionTable()
+    : start(0.0), limit(0.0), count(0), periods(NULL)
+{
+}
+
+TransitionTable::~TransitionTable()
+{
+    free(periods);
+}
+
+bool TransitionTable::build(TimeZone *tz, UDate start, UDate limit,
+                            UErrorCode &status)
+{
+    BasicTimeZone *btz = dynamic_cast<BasicTimeZone *>(tz);
+
+    count = 0;
+    if (btz == NULL)
+        return false;
+
+    int32_t size = 64;
+    Period *periods = (Period *) realloc(this->periods, size * sizeof(Period));
+
+    if (periods == NULL)
+    {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return false;
+    }
+    this->periods = periods;
+
+    btz->getOffset(start, false, periods[0].raw, periods[0].dst, status);
+    if (U_FAILURE(status))
+        return false;
+    periods[0].start = start;
+    count = 1;
+
+    TimeZoneTransition transition;
+    UDate date = start;
+
+    while (btz->getNextTransition(date, false, transition) &&
+           (date = transition.getTime()) < limit) {
+        if (count == size)
+        {
+            size *= 2;
+            periods = (Period *) realloc(periods, size * sizeof(Period));
+            if (periods == NULL)
+            {
+                count = 0;
+                status = U_MEMORY_ALLOCATION_ERROR;
+                return false;
+            }
+            this->periods = periods;
+        }
+
+        periods[count].start = date;
+        periods[count].raw = transition.getTo()->getRawOffset();
+        periods[count].dst = transition.getTo()->getDSTSavings();
+        count += 1;
+    }
+
+    this->start = start;
+    this->limit = limit;
+
+    return true;
+}
+
+int32_t TransitionTable::find(UDate date) const
+{
+    int32_t low = 0, high = count - 1;
+
+    while (low < high) {
+        int32_t middle = (low + high + 1) / 2;
+
+        if (periods[middle].start <= date)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    return low;
+}
+
+bool TransitionTable::getOffset(UDate date, int32_t &raw, int32_t &dst) const
+{
+    if (count == 0 || !(date >= start && date < limit))
+        return false;
+
+    const Period &period = periods[find(date)];
+
+    raw = period.raw;
+    dst = period.dst;
+
+    return true;
+}
+
+bool TransitionTable::getLocalOffset(UDate local,
+                                     int32_t &raw, int32_t &dst) const
+{
+    /* offsets are less than a day */
+    if (count == 0 || !(local >= start + U_MILLIS_PER_DAY &&
+                        local < limit - U_MILLIS_PER_DAY))
+        return false;
+
+    /* the period the local time would be in if it had its offset */
+    int32_t i = find(local - periods[0].raw - periods[0].dst);
+
+    while (i + 1 < count &&
+           periods[i + 1].start + periods[i + 1].raw + periods[i + 1].dst <=
+           local)
+        i += 1;
+    while (i > 0 && periods[i].start + periods[i].raw + periods[i].dst > local)
+        i -= 1;
+
+    const Period &period = periods[i];
+    int32_t offset = period.raw + period.dst;
+
+    if (i + 1 < count && local >= periods[i + 1].start + offset)
+        return false;  /* skipped */
+    if (i > 0 && local < period.start +
+        periods[i - 1].raw + periods[i - 1].dst)
+        return false;  /* repeated */
+
+    raw = period.raw;
+    dst = period.dst;
+
+    return true;
+}
+
 static PyObject *t_timezone_getOffset(t_timezone *self, PyObject *args)
 {
     UDate date;
@@ -930,6 +1084,203 @@ static PyObject *t_timezone_getOffset(t_timezone *self, PyObject *args)
     return PyErr_SetArgsError((PyObject *) self, "getOffset", args);
 }
 
+static void clearTransitions(t_timezone *self)
+{
+    delete self->transitions;
+    self->transitions = NULL;
+}
+
+/* Returns the cached transitions of the zone if they cover the window from
+ * start to limit, else NULL, or when extend is true, the cached transitions
+ * built or extended to cover it. Returns NULL if the zone doesn't support
+ * transitions. Called with the zone's lock held, doesn't use the GIL.
+ */
+static const TransitionTable *getTransitions(t_timezone *self,
+                                             UDate start, UDate limit,
+                                             bool extend, UErrorCode &status)
+{
+    TransitionTable *table = self->transitions;
+
+    if (table != NULL && start >= table->start && limit <= table->limit)
+        return table;
+
+    if (!extend)
+        return NULL;
+
+    if (table == NULL)
+    {
+        table = self->transitions = new TransitionTable();
+        if (table == NULL)
+        {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return NULL;
+        }
+    }
+    else
+    {
+        if (table->start < start)
+            start = table->start;
+        if (table->limit > limit)
+            limit = table->limit;
+    }
+
+    if (!table->build(self->object, start, limit, status) ||
+        U_FAILURE(status))
+    {
+        clearTransitions(self);
+        return NULL;
+    }
+
+    return table;
+}
+
+/* Computes the raw and dst offsets of count UTC dates, into consecutive
+ * pairs of offsets. Called with the zone's lock held, doesn't use the GIL.
+ */
+static void getOffsets(t_timezone *self, const UDate *dates, int32_t *offsets,
+                       Py_ssize_t count, UErrorCode &status)
+{
+    const TimeZone *tz = self->object;
+    const TransitionTable *table = NULL;
+
+    /* only worth building for enough dates */
+    if (count >= 64 || self->transitions != NULL)
+    {
+        UDate min = 0.0, max = 0.0;
+        bool found = false;
+
+        for (Py_ssize_t i = 0; i < count; i++) {
+            UDate date = dates[i];
+
+            if (date != date)  /* NaN */
+                continue;
+            if (!found || date < min)
+                min = date;
+            if (!found || date > max)
+                max = date;
+            found = true;
+        }
+
+        UDate start = daysFromCivil(TRANSITION_MIN_YEAR, 1, 1) *
+            U_MILLIS_PER_DAY;
+        UDate limit = daysFromCivil(TRANSITION_MAX_YEAR, 1, 1) *
+            U_MILLIS_PER_DAY;
+
+        if (min > start)
+            start = min;
+        if (max + 1 < limit)
+            limit = max + 1;
+
+        if (found && start < limit)
+        {
+            table = getTransitions(self, start, limit, count >= 64, status);
+            if (U_FAILURE(status))
+                return;
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int32_t &raw = offsets[i * 2], &dst = offsets[i * 2 + 1];
+
+        if (table == NULL || !table->getOffset(dates[i], raw, dst))
+        {
+            tz->getOffset(dates[i], false, raw, dst, status);
+            if (U_FAILURE(status))
+                return;
+        }
+    }
+}
+
+static PyObject *t_timezone_getOffsets(t_timezone *self, PyObject *args)
+{
+    PyObject *dates, *offsets;
+    Py_buffer dateView, offsetView;
+    Py_ssize_t count;
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        dates = PyTuple_GET_ITEM(args, 0);
+        offsets = NULL;
+        break;
+      case 2:
+        dates = PyTuple_GET_ITEM(args, 0);
+        offsets = PyTuple_GET_ITEM(args, 1);
+        break;
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "getOffsets", args);
+    }
+
+    if (PyObject_GetBuffer(dates, &dateView,
+                           PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+    {
+        PyErr_Clear();
+        return PyErr_SetArgsError((PyObject *) self, "getOffsets", args);
+    }
+
+    if (!isNativeFormat(&dateView, 'd', sizeof(UDate)))
+    {
+        PyBuffer_Release(&dateView);
+        return PyErr_SetArgsError((PyObject *) self, "getOffsets", args);
+    }
+    count = dateView.len / sizeof(UDate);
+
+    if (offsets == NULL)
+    {
+        offsets = PyByteArray_FromStringAndSize(
+            NULL, count * 2 * sizeof(int32_t));
+        if (offsets == NULL)
+        {
+            PyBuffer_Release(&dateView);
+            return NULL;
+        }
+    }
+    else
+        Py_INCREF(offsets);
+
+    if (PyObject_GetBuffer(offsets, &offsetView,
+                           PyBUF_WRITABLE | PyBUF_FORMAT |
+                           PyBUF_C_CONTIGUOUS) < 0)
+    {
+        PyErr_Clear();
+        PyBuffer_Release(&dateView);
+        Py_DECREF(offsets);
+        return PyErr_SetArgsError((PyObject *) self, "getOffsets", args);
+    }
+
+    if (!(PyByteArray_Check(offsets) ||
+          isNativeFormat(&offsetView, 'i', sizeof(int32_t)) ||
+          isNativeFormat(&offsetView, 'l', sizeof(int32_t))) ||
+        offsetView.len < (Py_ssize_t) (count * 2 * sizeof(int32_t)))
+    {
+        PyBuffer_Release(&offsetView);
+        PyBuffer_Release(&dateView);
+        Py_DECREF(offsets);
+        return PyErr_SetArgsError((PyObject *) self, "getOffsets", args);
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+
+    {
+        ObjectLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(
+            count >= ALLOW_THREADS_MIN_LENGTH,
+            getOffsets(self, (const UDate *) dateView.buf,
+                       (int32_t *) offsetView.buf, count, status));
+    }
+
+    PyBuffer_Release(&offsetView);
+    PyBuffer_Release(&dateView);
+
+    if (U_FAILURE(status))
+    {
+        Py_DECREF(offsets);
+        return ICUException(status).reportError();
+    }
+
+    return offsets;
+}
+
 static PyObject *t_timezone_getRawOffset(t_timezone *self)
 {
     return PyInt_FromLong(self->object->getRawOffset());
@@ -939,6 +1290,9 @@ static PyObject *t_timezone_setRawOffset(t_timezone *self, PyObject *arg)
 {
     int offset;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions(self);
+
     if (!parseArg(arg, "i", &offset))
     {
         self->object->setRawOffset(offset);
@@ -972,6 +1326,9 @@ static PyObject *t_timezone_setID(t_timezone *self, PyObject *arg)
 {
     UnicodeString *u, _u;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions(self);
+
     if (!parseArg(arg, "S", &u, &_u))
     {
         self->object->setID(*u); /* copied */
@@ -1510,6 +1867,9 @@ static int t_simpletimezone_init(t_simpletimezone *self,
     int savingsEndDayOfWeekInMonth, savingsEndDayOfWeek, savingsEndTime;
     SimpleTimeZone::TimeMode startMode, endMode;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions((t_timezone *) self);
+
     switch (PyTuple_Size(args)) {
       case 2:
         if (!parseArgs(args, "iS", &rawOffsetGMT, &u, &_u))
@@ -1578,6 +1938,9 @@ static PyObject *t_simpletimezone_setStartYear(t_simpletimezone *self,
 {
     int year;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions((t_timezone *) self);
+
     if (!parseArg(arg, "i", &year))
     {
         self->object->setStartYear(year);
@@ -1594,6 +1957,9 @@ static PyObject *t_simpletimezone_setStartRule(t_simpletimezone *self,
     int month, dayOfMonth, dayOfWeek, dayOfWeekInMonth, time;
     int after;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions((t_timezone *) self);
+
     switch (PyTuple_Size(args)) {
       case 3:
         if (!parseArgs(args, "iii", &month, &dayOfMonth, &time))
@@ -1651,6 +2017,9 @@ static PyObject *t_simpletimezone_setEndRule(t_simpletimezone *self,
     int month, dayOfMonth, dayOfWeek, dayOfWeekInMonth, time;
     int after;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions((t_timezone *) self);
+
     switch (PyTuple_Size(args)) {
       case 3:
         if (!parseArgs(args, "iii", &month, &dayOfMonth, &time))
@@ -1722,6 +2091,9 @@ static PyObject *t_simpletimezone_setDSTSavings(t_simpletimezone *self,
 {
     int savings;
 
+    ObjectLocker locker(self->lock);
+    clearTransitions((t_timezone *) self);
+
     if (!parseArg(arg, "i", &savings))
     {
         STATUS_CALL(self->object->setDSTSavings(savings, status));
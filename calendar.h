@@ -24,14 +24,57 @@
 #ifndef _calendar_h
 #define _calendar_h
 
+extern PyTypeObject CalendarType_;
+extern PyTypeObject TimeZoneType_;
+
+/* The offsets of a BasicTimeZone between its transitions in a window of
+ * time, for answering offset queries with a binary search instead of going
+ * through the zone's rules each time. Times are in milliseconds. Windows
+ * are kept between TRANSITION_MIN_YEAR and TRANSITION_MAX_YEAR.
+ */
+#define TRANSITION_MIN_YEAR 1800
+#define TRANSITION_MAX_YEAR 2200
+
+class TransitionTable {
+public:
+    struct Period {
+        UDate start;   /* UTC */
+        int32_t raw, dst;
+    };
+
+    TransitionTable();
+    ~TransitionTable();
+
+    /* Returns false if the zone doesn't support transitions */
+    bool build(TimeZone *tz, UDate start, UDate limit, UErrorCode &status);
+
+    /* Returns false if date is outside of the window */
+    bool getOffset(UDate date, int32_t &raw, int32_t &dst) const;
+
+    /* Returns false if local is outside of the window or is a local time
+     * that is skipped or repeated around a transition.
+     */
+    bool getLocalOffset(UDate local, int32_t &raw, int32_t &dst) const;
+
+    UDate start, limit;
+    int32_t count;
+    Period *periods;
+
+private:
+    int32_t find(UDate date) const;
+};
+
+/* The transitions cached by TimeZone.getOffsets() are dropped by the
+ * setters, which hold lock, like getOffsets() does while using them without
+ * the GIL. The wrappers of TimeZone subclasses have the same fields.
+ */
 class t_timezone : public _wrapper {
 public:
     TimeZone *object;
+    ObjectLock lock;
+    TransitionTable *transitions;
 };
 
-extern PyTypeObject CalendarType_;
-extern PyTypeObject TimeZoneType_;
-
 
 PyObject *wrap_Calendar(Calendar *, int);
 PyObject *wrap_TimeZone(TimeZone *, int);
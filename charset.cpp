@@ -35,6 +35,8 @@ class t_charsetdetector : public _wrapper {
 public:
     UCharsetDetector *object;
     PyObject *text;
+    Py_buffer view;  /* of text, held while text is set */
+    ObjectLock lock;
 };
 
 static int t_charsetdetector_init(t_charsetdetector *self,
@@ -49,6 +51,8 @@ static PyObject *t_charsetdetector_enableInputFilter(t_charsetdetector *self,
                                                      PyObject *arg);
 static PyObject *t_charsetdetector_isInputFilterEnabled(t_charsetdetector *self);
 static PyObject *t_charsetdetector_getAllDetectableCharsets(t_charsetdetector *self);
+static PyObject *t_charsetdetector_detectSampled(t_charsetdetector *self,
+                                                 PyObject *args);
 
 static PyMethodDef t_charsetdetector_methods[] = {
     DECLARE_METHOD(t_charsetdetector, setText, METH_O),
@@ -58,6 +62,7 @@ static PyMethodDef t_charsetdetector_methods[] = {
     DECLARE_METHOD(t_charsetdetector, enableInputFilter, METH_O),
     DECLARE_METHOD(t_charsetdetector, isInputFilterEnabled, METH_NOARGS),
     DECLARE_METHOD(t_charsetdetector, getAllDetectableCharsets, METH_NOARGS),
+    DECLARE_METHOD(t_charsetdetector, detectSampled, METH_VARARGS),
     { NULL, NULL, 0, NULL }
 };
 
@@ -68,7 +73,10 @@ static void t_charsetdetector_dealloc(t_charsetdetector *self)
         ucsdet_close(self->object);
         self->object = NULL;
     }
+    if (self->text != NULL)
+        PyBuffer_Release(&self->view);
     Py_CLEAR(self->text);
+    self->lock.free();
 
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
@@ -111,14 +119,120 @@ DECLARE_STRUCT(CharsetMatch, t_charsetmatch, UCharsetMatch,
                abstract_init, t_charsetmatch_dealloc)
 
 
+/* Converter */
+
+enum {
+    CONVERTER_STRICT,
+    CONVERTER_REPLACE,
+    CONVERTER_IGNORE,
+    CONVERTER_BACKSLASHREPLACE,
+    CONVERTER_XMLCHARREFREPLACE,
+};
+
+#define CONVERTER_PIVOT_SIZE 1024
+
+class t_converter : public _wrapper {
+public:
+    UConverter *object;
+    int errors;
+    UErrorCode error;     /* set by a strict callback that stopped */
+    int32_t errorLength;  /* of the invalid sequence that stopped */
+    UChar errorChars[2];  /* the invalid sequence when encoding */
+    UChar *pivotSource, *pivotTarget;  /* into pivot, between convert()s */
+    UChar pivot[CONVERTER_PIVOT_SIZE];
+    ObjectLock lock;
+};
+
+static int t_converter_init(t_converter *self, PyObject *args, PyObject *kwds);
+static PyObject *t_converter_getName(t_converter *self);
+static PyObject *t_converter_getErrors(t_converter *self);
+static PyObject *t_converter_setErrors(t_converter *self, PyObject *arg);
+static PyObject *t_converter_reset(t_converter *self);
+static PyObject *t_converter_decode(t_converter *self, PyObject *args);
+static PyObject *t_converter_encode(t_converter *self, PyObject *args);
+static PyObject *t_converter_convert(t_converter *self, PyObject *args);
+static PyObject *t_converter_convertFile(t_converter *self, PyObject *args);
+
+static PyMethodDef t_converter_methods[] = {
+    DECLARE_METHOD(t_converter, getName, METH_NOARGS),
+    DECLARE_METHOD(t_converter, getErrors, METH_NOARGS),
+    DECLARE_METHOD(t_converter, setErrors, METH_O),
+    DECLARE_METHOD(t_converter, reset, METH_NOARGS),
+    DECLARE_METHOD(t_converter, decode, METH_VARARGS),
+    DECLARE_METHOD(t_converter, encode, METH_VARARGS),
+    DECLARE_METHOD(t_converter, convert, METH_VARARGS),
+    DECLARE_METHOD(t_converter, convertFile, METH_VARARGS),
+    { NULL, NULL, 0, NULL }
+};
+
+static void t_converter_dealloc(t_converter *self)
+{
+    if (self->object)
+    {
+        ucnv_close(self->object);
+        self->object = NULL;
+    }
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+DECLARE_STRUCT(Converter, t_converter, UConverter,
+               t_converter_init, t_converter_dealloc)
+
+
 /* CharsetDetector */
 
+/* ICU only examines the first kBufSize bytes of its input */
+#define CHARSET_DETECTOR_WINDOW_SIZE 8192
+#define CHARSET_DETECTOR_MAX_MATCHES 64
+
+static inline int32_t textLength(t_charsetdetector *self)
+{
+    if (self->text == NULL)
+        return 0;
+
+    return self->view.len > INT32_MAX ? INT32_MAX : (int32_t) self->view.len;
+}
+
+/* Sets the detector's text to any object supporting the buffer protocol,
+ * such as bytes, bytearray, memoryview or mmap. The buffer is held, not
+ * copied, until the text is set again.
+ */
+static int setText(t_charsetdetector *self, PyObject *arg)
+{
+    Py_buffer view;
+
+    if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) < 0)
+        return -1;
+
+    UErrorCode status = U_ZERO_ERROR;
+
+    ucsdet_setText(self->object, (const char *) view.buf,
+                   view.len > INT32_MAX ? INT32_MAX : (int32_t) view.len,
+                   &status);
+    if (U_FAILURE(status))
+    {
+        PyBuffer_Release(&view);
+        ICUException(status).reportError();
+        return -1;
+    }
+
+    if (self->text != NULL)
+        PyBuffer_Release(&self->view);
+    Py_INCREF(arg);
+    Py_XDECREF(self->text);
+    self->text = arg;
+    self->view = view;
+
+    return 0;
+}
+
 static int t_charsetdetector_init(t_charsetdetector *self,
                                   PyObject *args, PyObject *kwds)
 {
-    const char *text;
+    PyObject *text;
     charsArg encoding;
-    int textSize;
 
     switch (PyTuple_Size(args)) {
       case 0:
@@ -126,28 +240,25 @@ static int t_charsetdetector_init(t_charsetdetector *self,
         break;
 
       case 1:
-        if (!parseArgs(args, "k", &text, &textSize))
+        if (!parseArgs(args, "K", &text) && PyObject_CheckBuffer(text))
         {
             INT_STATUS_CALL(self->object = ucsdet_open(&status));
-            INT_STATUS_CALL(ucsdet_setText(self->object, text, textSize,
-                                           &status));
-            self->text = PyTuple_GetItem(args, 0);
-            Py_INCREF(self->text);
+            if (setText(self, text) < 0)
+                return -1;
             break;
         }
         PyErr_SetArgsError((PyObject *) self, "__init__", args);
         return -1;
 
       case 2:
-        if (!parseArgs(args, "kn", &text, &textSize, &encoding))
+        if (!parseArgs(args, "Kn", &text, &encoding) &&
+            PyObject_CheckBuffer(text))
         {
             INT_STATUS_CALL(self->object = ucsdet_open(&status));
-            INT_STATUS_CALL(ucsdet_setText(self->object, text,
-                                           textSize, &status));
+            if (setText(self, text) < 0)
+                return -1;
             INT_STATUS_CALL(ucsdet_setDeclaredEncoding(self->object, encoding,
                                                        -1, &status));
-            self->text = PyTuple_GetItem(args, 0);
-            Py_INCREF(self->text);
             break;
         }
         PyErr_SetArgsError((PyObject *) self, "__init__", args);
@@ -167,17 +278,12 @@ static int t_charsetdetector_init(t_charsetdetector *self,
 static PyObject *t_charsetdetector_setText(t_charsetdetector *self,
                                            PyObject *arg)
 {
-    const char *text;
-    int size;
+    ObjectLocker locker(self->lock);
 
-    if (!parseArg(arg, "k", &text, &size))
+    if (PyObject_CheckBuffer(arg))
     {
-        /* ref'd */
-        STATUS_CALL(ucsdet_setText(self->object, text, size, &status));
-
-        Py_INCREF(arg);
-        Py_XDECREF(self->text);
-        self->text = arg;
+        if (setText(self, arg) < 0)  /* ref'd */
+            return NULL;
 
         Py_RETURN_NONE;
     }
@@ -190,6 +296,7 @@ static PyObject *t_charsetdetector_setDeclaredEncoding(t_charsetdetector *self,
 {
     const char *encoding;
     int size;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "k", &encoding, &size))
     {
@@ -202,12 +309,19 @@ static PyObject *t_charsetdetector_setDeclaredEncoding(t_charsetdetector *self,
     return PyErr_SetArgsError((PyObject *) self, "setDeclaredEncoding", arg);
 }
 
+static inline int allowThreads(t_charsetdetector *self)
+{
+    return allowThreads(textLength(self));
+}
+
 static PyObject *t_charsetdetector_detect(t_charsetdetector *self)
 {
     const UCharsetMatch *match;
     PyObject *result;
+    ObjectLocker locker(self->lock);
 
-    STATUS_CALL(match = ucsdet_detect(self->object, &status));
+    STATUS_ALLOW_THREADS_CALL(allowThreads(self),
+                              match = ucsdet_detect(self->object, &status));
 
     result = wrap_CharsetMatch((UCharsetMatch *) match, 0);
     if (result)
@@ -224,8 +338,11 @@ static PyObject *t_charsetdetector_detectAll(t_charsetdetector *self)
     const UCharsetMatch **matches;
     PyObject *result;
     int found = 0;
+    ObjectLocker locker(self->lock);
 
-    STATUS_CALL(matches = ucsdet_detectAll(self->object, &found, &status));
+    STATUS_ALLOW_THREADS_CALL(
+        allowThreads(self),
+        matches = ucsdet_detectAll(self->object, &found, &status));
     result = PyTuple_New(found);
 
     for (int i = 0; i < found; i++) {
@@ -252,6 +369,7 @@ static PyObject *t_charsetdetector_enableInputFilter(t_charsetdetector *self,
                                                      PyObject *arg)
 {
     UBool filter;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "B", &filter))
     {
@@ -279,11 +397,171 @@ static PyObject *t_charsetdetector_getAllDetectableCharsets(t_charsetdetector *s
 }
 
 
+struct sampledMatch {
+    const char *name;
+    const char *language;
+    int confidence;  // summed over the windows
+    int best;        // in a single window, for the language
+};
+
+/* Detects the charsets of count windows of size bytes spread evenly over
+ * text, from its head to its tail, into matches. Windows other than the
+ * head start after a line break when there is one in their first quarter,
+ * so as to not begin in the middle of a multibyte sequence. The detector's
+ * text is left set to the last window. Returns the number of matches.
+ */
+static int detectSampled(UCharsetDetector *detector,
+                         const char *text, Py_ssize_t length,
+                         int count, int32_t size,
+                         sampledMatch *matches, UErrorCode &status)
+{
+    int found = 0;
+
+    if (size > length)
+        size = (int32_t) length;
+    if (count > 1 && (Py_ssize_t) count * size > length)
+        count = (int) (length / (size > 0 ? size : 1));
+    if (count < 1)
+        count = 1;
+
+    for (int i = 0; i < count; ++i) {
+        Py_ssize_t start = count == 1 ? 0 : (length - size) / (count - 1) * i;
+        int32_t windowSize = size;
+
+        if (i > 0)
+        {
+            const char *eol = (const char *) memchr(text + start, '\n',
+                                                    size / 4);
+
+            if (eol != NULL)
+            {
+                windowSize -= (int32_t) (eol + 1 - (text + start));
+                start = eol + 1 - text;
+            }
+        }
+
+        const UCharsetMatch **windowMatches;
+        int windowFound = 0;
+
+        ucsdet_setText(detector, text + start, windowSize, &status);
+        windowMatches = ucsdet_detectAll(detector, &windowFound, &status);
+        if (U_FAILURE(status))
+            return 0;
+
+        for (int j = 0; j < windowFound; ++j) {
+            const char *name = ucsdet_getName(windowMatches[j], &status);
+            const char *language =
+                ucsdet_getLanguage(windowMatches[j], &status);
+            int confidence =
+                ucsdet_getConfidence(windowMatches[j], &status);
+            int k = 0;
+
+            if (U_FAILURE(status))
+                return 0;
+
+            // names are static strings in ICU's recognizers
+            while (k < found && strcmp(matches[k].name, name))
+                k += 1;
+
+            if (k == found)
+            {
+                if (found == CHARSET_DETECTOR_MAX_MATCHES)
+                    continue;
+                matches[k].name = name;
+                matches[k].language = language;
+                matches[k].confidence = 0;
+                matches[k].best = -1;
+                found += 1;
+            }
+
+            matches[k].confidence += confidence;
+            if (confidence > matches[k].best)
+            {
+                matches[k].best = confidence;
+                matches[k].language = language;
+            }
+        }
+    }
+
+    for (int k = 0; k < found; ++k)
+        matches[k].confidence /= count;
+
+    // by decreasing confidence, insertion sort over a few dozen matches
+    for (int k = 1; k < found; ++k) {
+        sampledMatch match = matches[k];
+        int j = k;
+
+        for (; j > 0 && matches[j - 1].confidence < match.confidence; --j)
+            matches[j] = matches[j - 1];
+        matches[j] = match;
+    }
+
+    return found;
+}
+
+static PyObject *t_charsetdetector_detectSampled(t_charsetdetector *self,
+                                                 PyObject *args)
+{
+    int count = 3, size = CHARSET_DETECTOR_WINDOW_SIZE;
+    ObjectLocker locker(self->lock);
+
+    switch (PyTuple_Size(args)) {
+      case 0:
+        break;
+      case 1:
+        if (!parseArgs(args, "i", &count) && count > 0)
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "detectSampled", args);
+      case 2:
+        if (!parseArgs(args, "ii", &count, &size) && count > 0 && size > 0)
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "detectSampled", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "detectSampled", args);
+    }
+
+    if (self->text == NULL)
+        return PyTuple_New(0);
+
+    sampledMatch matches[CHARSET_DETECTOR_MAX_MATCHES];
+    const char *text = (const char *) self->view.buf;
+    Py_ssize_t length = self->view.len;
+    int found;
+
+    // the detector's text is set back to the whole text afterwards
+    STATUS_ALLOW_THREADS_CALL(
+        allowThreads(self) || length > size,
+        {
+            UErrorCode restored = U_ZERO_ERROR;
+
+            found = detectSampled(self->object, text, length, count, size,
+                                  matches, status);
+            ucsdet_setText(self->object, text, textLength(self), &restored);
+        });
+
+    PyObject *result = PyTuple_New(found);
+
+    for (int i = 0; result != NULL && i < found; ++i) {
+        PyObject *match = Py_BuildValue("(sis)", matches[i].name,
+                                        matches[i].confidence,
+                                        matches[i].language);
+
+        if (match == NULL)
+            Py_CLEAR(result);
+        else
+            PyTuple_SET_ITEM(result, i, match);
+    }
+
+    return result;
+}
+
+
 /* CharsetMatch */
 
 static PyObject *t_charsetmatch_getName(t_charsetmatch *self)
 {
     const char *name;
+    ObjectLocker locker(self->detector->lock);
 
     STATUS_CALL(name = ucsdet_getName(self->object, &status));
     return PyString_FromString(name);
@@ -292,6 +570,7 @@ static PyObject *t_charsetmatch_getName(t_charsetmatch *self)
 static PyObject *t_charsetmatch_getConfidence(t_charsetmatch *self)
 {
     int confidence;
+    ObjectLocker locker(self->detector->lock);
 
     STATUS_CALL(confidence = ucsdet_getConfidence(self->object, &status));
     return PyInt_FromLong(confidence);
@@ -300,6 +579,7 @@ static PyObject *t_charsetmatch_getConfidence(t_charsetmatch *self)
 static PyObject *t_charsetmatch_getLanguage(t_charsetmatch *self)
 {
     const char *language;
+    ObjectLocker locker(self->detector->lock);
 
     STATUS_CALL(language = ucsdet_getLanguage(self->object, &status));
     return PyString_FromString(language);
@@ -309,8 +589,9 @@ static PyObject *t_charsetmatch_str(t_charsetmatch *self)
 {
     if (self->detector && self->detector->text)
     {
+        ObjectLocker locker(self->detector->lock);
         UErrorCode status = U_ZERO_ERROR;
-        int size = (int) PyBytes_GET_SIZE(self->detector->text);
+        int size = textLength(self->detector);
         UChar *buf = new UChar[size];
         PyObject *u;
 
@@ -341,10 +622,716 @@ static PyObject *t_charsetmatch_str(t_charsetmatch *self)
 }
 
 
+/* Converter */
+
+static const char *errorNames[] = {
+    "strict", "replace", "ignore", "backslashreplace", "xmlcharrefreplace",
+};
+
+/* The error callbacks delegate to ICU's callbacks according to the errors
+ * mode, with xmlcharrefreplace only applying to encoding like in python.
+ * In strict mode, they record why and on how long a sequence they stopped
+ * so that a python UnicodeError can be raised.
+ */
+static void U_CALLCONV toUCallback(const void *context,
+                                   UConverterToUnicodeArgs *args,
+                                   const char *chars, int32_t length,
+                                   UConverterCallbackReason reason,
+                                   UErrorCode *err)
+{
+    t_converter *self = (t_converter *) context;
+
+    switch (self->errors) {
+      case CONVERTER_REPLACE:
+        UCNV_TO_U_CALLBACK_SUBSTITUTE(NULL, args, chars, length, reason, err);
+        break;
+      case CONVERTER_IGNORE:
+        UCNV_TO_U_CALLBACK_SKIP(NULL, args, chars, length, reason, err);
+        break;
+      case CONVERTER_BACKSLASHREPLACE:
+        UCNV_TO_U_CALLBACK_ESCAPE(UCNV_ESCAPE_C, args, chars, length,
+                                  reason, err);
+        break;
+      default:
+        if (reason <= UCNV_IRREGULAR)
+        {
+            self->error = *err;
+            self->errorLength = length;
+        }
+        break;
+    }
+}
+
+static void U_CALLCONV fromUCallback(const void *context,
+                                     UConverterFromUnicodeArgs *args,
+                                     const UChar *chars, int32_t length,
+                                     UChar32 c,
+                                     UConverterCallbackReason reason,
+                                     UErrorCode *err)
+{
+    t_converter *self = (t_converter *) context;
+
+    switch (self->errors) {
+      case CONVERTER_REPLACE:
+        UCNV_FROM_U_CALLBACK_SUBSTITUTE(NULL, args, chars, length, c,
+                                        reason, err);
+        break;
+      case CONVERTER_IGNORE:
+        UCNV_FROM_U_CALLBACK_SKIP(NULL, args, chars, length, c, reason, err);
+        break;
+      case CONVERTER_BACKSLASHREPLACE:
+        UCNV_FROM_U_CALLBACK_ESCAPE(UCNV_ESCAPE_C, args, chars, length, c,
+                                    reason, err);
+        break;
+      case CONVERTER_XMLCHARREFREPLACE:
+        UCNV_FROM_U_CALLBACK_ESCAPE(UCNV_ESCAPE_XML_DEC, args, chars, length,
+                                    c, reason, err);
+        break;
+      default:
+        if (reason <= UCNV_IRREGULAR)
+        {
+            self->error = *err;
+            self->errorLength = length < 2 ? length : 2;
+            u_memcpy(self->errorChars, chars, self->errorLength);
+        }
+        break;
+    }
+}
+
+static int setErrors(t_converter *self, const char *errors)
+{
+    for (int i = 0; i < (int) (sizeof(errorNames) / sizeof(char *)); ++i) {
+        if (!strcmp(errors, errorNames[i]))
+        {
+            self->errors = i;
+            return 0;
+        }
+    }
+
+    PyErr_Format(PyExc_LookupError, "unknown error handler name '%s'",
+                 errors);
+
+    return -1;
+}
+
+static int t_converter_init(t_converter *self, PyObject *args, PyObject *kwds)
+{
+    charsArg encoding, errors;
+
+    // the converter may be in use by another thread without the GIL
+    if (self->object != NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Converter already initialized");
+        return -1;
+    }
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "n", &encoding))
+            break;
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+      case 2:
+        if (!parseArgs(args, "nn", &encoding, &errors))
+        {
+            if (setErrors(self, errors) < 0)
+                return -1;
+            break;
+        }
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+      default:
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+    }
+
+    UConverter *conv;
+
+    INT_STATUS_CALL(conv = ucnv_open(encoding, &status));
+    INT_STATUS_CALL(
+        {
+            ucnv_setToUCallBack(conv, toUCallback, self, NULL, NULL,
+                                &status);
+            ucnv_setFromUCallBack(conv, fromUCallback, self, NULL, NULL,
+                                  &status);
+            if (U_FAILURE(status))
+                ucnv_close(conv);
+        });
+
+    self->object = conv;
+    self->flags = T_OWNED;
+    self->pivotSource = self->pivotTarget = self->pivot;
+
+    return 0;
+}
+
+static PyObject *t_converter_getName(t_converter *self)
+{
+    const char *name;
+
+    STATUS_CALL(name = ucnv_getName(self->object, &status));
+
+    return PyString_FromString(name);
+}
+
+static PyObject *t_converter_getErrors(t_converter *self)
+{
+    return PyString_FromString(errorNames[self->errors]);
+}
+
+static PyObject *t_converter_setErrors(t_converter *self, PyObject *arg)
+{
+    charsArg errors;
+
+    if (!parseArg(arg, "n", &errors))
+    {
+        if (setErrors(self, errors) < 0)
+            return NULL;
+
+        Py_RETURN_NONE;
+    }
+
+    return PyErr_SetArgsError((PyObject *) self, "setErrors", arg);
+}
+
+static void reset(t_converter *self)
+{
+    ucnv_reset(self->object);
+    self->pivotSource = self->pivotTarget = self->pivot;
+}
+
+static PyObject *t_converter_reset(t_converter *self)
+{
+    ObjectLocker locker(self->lock);
+
+    reset(self);
+    Py_RETURN_NONE;
+}
+
+static const char *errorReason(UErrorCode status)
+{
+    switch (status) {
+      case U_INVALID_CHAR_FOUND:
+        return "unmappable character";
+      case U_ILLEGAL_CHAR_FOUND:
+        return "illegal sequence";
+      case U_TRUNCATED_CHAR_FOUND:
+        return "truncated sequence";
+      default:
+        return u_errorName(status);
+    }
+}
+
+/* Raises the UnicodeDecodeError for the sequence self stopped on, which
+ * ends at offset end of the bytes in data, and resets self.
+ */
+static PyObject *raiseDecodeError(t_converter *self,
+                                  const char *data, Py_ssize_t length,
+                                  Py_ssize_t end, const char *reason)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    Py_ssize_t start = end - self->errorLength;
+    PyObject *bytes = PyBytes_FromStringAndSize(data, length);
+
+    if (start < 0)  // the sequence began in a previous chunk
+        start = 0;
+
+    if (bytes != NULL)
+    {
+        PyObject *error = PyObject_CallFunction(
+            PyExc_UnicodeDecodeError, (char *) "sOnns",
+            ucnv_getName(self->object, &status), bytes, start, end,
+            reason != NULL ? reason : errorReason(self->error));
+
+        if (error != NULL)
+        {
+            PyErr_SetObject(PyExc_UnicodeDecodeError, error);
+            Py_DECREF(error);
+        }
+        Py_DECREF(bytes);
+    }
+    reset(self);
+
+    return NULL;
+}
+
+/* Raises the UnicodeEncodeError for the sequence self stopped on, which
+ * ends at offset end of the UTF-16 text, and resets self.
+ */
+static PyObject *raiseEncodeError(t_converter *self, const UnicodeString &u,
+                                  PyObject *text, int32_t end,
+                                  const char *reason)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t start = end - self->errorLength;
+    PyObject *object = text;
+
+    if (start < 0)  // the sequence began in a previous chunk
+        start = 0;
+
+    if (object == NULL || !PyUnicode_Check(object))
+        object = PyUnicode_FromUnicodeString(&u);
+    else
+        Py_INCREF(object);
+
+    if (object != NULL)
+    {
+        // python offsets are in code points
+        PyObject *error = PyObject_CallFunction(
+            PyExc_UnicodeEncodeError, (char *) "sOnns",
+            ucnv_getName(self->object, &status), object,
+            (Py_ssize_t) u.countChar32(0, start),
+            (Py_ssize_t) u.countChar32(0, end),
+            reason != NULL ? reason : errorReason(self->error));
+
+        if (error != NULL)
+        {
+            PyErr_SetObject(PyExc_UnicodeEncodeError, error);
+            Py_DECREF(error);
+        }
+        Py_DECREF(object);
+    }
+    reset(self);
+
+    return NULL;
+}
+
+static void toUnicode(UConverter *conv, UnicodeString &u,
+                      const char **source, const char *sourceLimit,
+                      bool flush, UErrorCode &status)
+{
+    int32_t capacity = (int32_t) (sourceLimit - *source) + 16;
+    int32_t size = 0;
+
+    // a byte may decode to more than one UChar, grow the buffer as needed
+    while (true) {
+        UChar *buffer = u.getBuffer(capacity);
+
+        if (buffer == NULL)
+        {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+
+        UChar *target = buffer + size;
+
+        ucnv_toUnicode(conv, &target, buffer + capacity,
+                       source, sourceLimit, NULL, flush, &status);
+        size = (int32_t) (target - buffer);
+        u.releaseBuffer(size);
+
+        if (status != U_BUFFER_OVERFLOW_ERROR)
+            return;
+
+        status = U_ZERO_ERROR;
+        if (capacity > INT32_MAX / 2 - 16)
+        {
+            status = U_INDEX_OUTOFBOUNDS_ERROR;
+            return;
+        }
+        capacity = capacity * 2 + 16;
+    }
+}
+
+static PyObject *t_converter_decode(t_converter *self, PyObject *args)
+{
+    PyObject *data;
+    int final = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "K", &data) && PyObject_CheckBuffer(data))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "decode", args);
+      case 2:
+        if (!parseArgs(args, "Kb", &data, &final) &&
+            PyObject_CheckBuffer(data))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "decode", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "decode", args);
+    }
+
+    Py_buffer view;
+
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    if (view.len > INT32_MAX - 16)
+    {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_OverflowError, "data is too large to decode");
+        return NULL;
+    }
+
+    ObjectLocker locker(self->lock);
+    const char *buffer = (const char *) view.buf;
+    const char *source = buffer;
+    UErrorCode status = U_ZERO_ERROR;
+    UnicodeString u;
+
+    self->error = U_ZERO_ERROR;
+    ALLOW_THREADS_CALL(
+        allowThreads((int32_t) view.len),
+        toUnicode(self->object, u, &source, buffer + view.len, final,
+                  status));
+
+    PyObject *result;
+
+    if (U_SUCCESS(status))
+        result = PyUnicode_FromUnicodeString(&u);
+    else if (self->error != U_ZERO_ERROR)
+        result = raiseDecodeError(self, buffer, view.len, source - buffer,
+                                  NULL);
+    else
+    {
+        reset(self);
+        result = ICUException(status).reportError();
+    }
+
+    PyBuffer_Release(&view);
+
+    return result;
+}
+
+static PyObject *t_converter_encode(t_converter *self, PyObject *args)
+{
+    UnicodeString *u, _u;
+    int final = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "S", &u, &_u))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "encode", args);
+      case 2:
+        if (!parseArgs(args, "Sb", &u, &_u, &final))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "encode", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "encode", args);
+    }
+
+    ObjectLocker locker(self->lock);
+    const UChar *chars = u->getBuffer();
+    const UChar *source = chars;
+    const UChar *sourceLimit = chars + u->length();
+    Py_ssize_t capacity =
+        ((Py_ssize_t) u->length() + 10) * ucnv_getMaxCharSize(self->object);
+    Py_ssize_t size = 0;
+    PyObject *bytes = PyBytes_FromStringAndSize(NULL, capacity);
+    UErrorCode status = U_ZERO_ERROR;
+
+    if (bytes == NULL)
+        return NULL;
+
+    self->error = U_ZERO_ERROR;
+
+    // only escaping callbacks may produce more than capacity bytes
+    while (true) {
+        char *buffer = PyBytes_AS_STRING(bytes);
+        char *target = buffer + size;
+
+        ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            ucnv_fromUnicode(self->object, &target, buffer + capacity,
+                             &source, sourceLimit, NULL, final, &status));
+        size = target - buffer;
+
+        if (status != U_BUFFER_OVERFLOW_ERROR)
+            break;
+
+        status = U_ZERO_ERROR;
+        capacity *= 2;
+        if (_PyBytes_Resize(&bytes, capacity) < 0)
+        {
+            reset(self);
+            return NULL;
+        }
+    }
+
+    if (U_FAILURE(status))
+    {
+        Py_DECREF(bytes);
+
+        if (self->error != U_ZERO_ERROR)
+            return raiseEncodeError(self, *u, PyTuple_GET_ITEM(args, 0),
+                                    (int32_t) (source - chars), NULL);
+
+        reset(self);
+        return ICUException(status).reportError();
+    }
+
+    if (_PyBytes_Resize(&bytes, size) < 0)
+        return NULL;
+
+    return bytes;
+}
+
+/* Raises the UnicodeError for the conversion from self to target that
+ * stopped, source is the offset where it stopped in the bytes converted,
+ * offset the offset of these bytes in a file or -1.
+ */
+static PyObject *raiseConvertError(t_converter *self, t_converter *target,
+                                   const char *data, Py_ssize_t length,
+                                   Py_ssize_t source, Py_ssize_t offset,
+                                   UErrorCode status)
+{
+    char reason[64];
+
+    if (self->error != U_ZERO_ERROR)
+    {
+        if (offset < 0)
+            raiseDecodeError(self, data, length, source, NULL);
+        else
+        {
+            Py_ssize_t start = source - self->errorLength;
+
+            // the invalid sequence alone, with its offset in the file
+            PyOS_snprintf(reason, sizeof(reason), "%s at offset %lld",
+                          errorReason(self->error),
+                          (long long) (offset + start));
+            if (start < 0)
+                start = 0;
+            raiseDecodeError(self, data + start, source - start,
+                             source - start, reason);
+        }
+        reset(target);
+    }
+    else if (target->error != U_ZERO_ERROR)
+    {
+        UnicodeString u(target->errorChars, target->errorLength);
+
+        // offsets are lost in the pivot, only the invalid sequence is known
+        raiseEncodeError(target, u, NULL, u.length(), NULL);
+        reset(self);
+    }
+    else
+    {
+        reset(self);
+        reset(target);
+        ICUException(status).reportError();
+    }
+
+    return NULL;
+}
+
+static PyObject *t_converter_convert(t_converter *self, PyObject *args)
+{
+    t_converter *target;
+    PyObject *data, *buffer;
+    int final = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 3:
+        if (!parseArgs(args, "OKK", &ConverterType_, &target,
+                       &data, &buffer) &&
+            target != self && PyObject_CheckBuffer(data))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "convert", args);
+      case 4:
+        if (!parseArgs(args, "OKKb", &ConverterType_, &target,
+                       &data, &buffer, &final) &&
+            target != self && PyObject_CheckBuffer(data))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "convert", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "convert", args);
+    }
+
+    Py_buffer in, out;
+
+    if (PyObject_GetBuffer(data, &in, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    if (PyObject_GetBuffer(buffer, &out, PyBUF_WRITABLE) < 0)
+    {
+        PyBuffer_Release(&in);
+        return NULL;
+    }
+
+    // in address order, so that a.convert(b) and b.convert(a) can't deadlock
+    ObjectLocker firstLocker(self < target ? self->lock : target->lock);
+    ObjectLocker secondLocker(self < target ? target->lock : self->lock);
+    const char *source = (const char *) in.buf;
+    char *output = (char *) out.buf;
+    UErrorCode status = U_ZERO_ERROR;
+
+    self->error = target->error = U_ZERO_ERROR;
+    ALLOW_THREADS_CALL(
+        allowThreads((int32_t) (in.len < INT32_MAX ? in.len : INT32_MAX)),
+        ucnv_convertEx(target->object, self->object, &output,
+                       (char *) out.buf + out.len,
+                       &source, (const char *) in.buf + in.len,
+                       self->pivot, &self->pivotSource, &self->pivotTarget,
+                       self->pivot + CONVERTER_PIVOT_SIZE,
+                       false, final, &status));
+
+    PyObject *result;
+
+    if (U_SUCCESS(status) || status == U_BUFFER_OVERFLOW_ERROR)
+        result = Py_BuildValue(
+            "(nn)", (Py_ssize_t) (source - (const char *) in.buf),
+            (Py_ssize_t) (output - (char *) out.buf));
+    else
+        result = raiseConvertError(
+            self, target, (const char *) in.buf, in.len,
+            source - (const char *) in.buf, -1, status);
+
+    PyBuffer_Release(&out);
+    PyBuffer_Release(&in);
+
+    return result;
+}
+
+/* Converts all of input into output from self to target, reading and
+ * writing size bytes at a time. Returns errno on I/O error.
+ */
+static int convertFile(t_converter *self, t_converter *target,
+                       FILE *input, FILE *output,
+                       char *inBuffer, char *outBuffer, size_t size,
+                       Py_ssize_t &read, Py_ssize_t &written,
+                       Py_ssize_t &stopped, UErrorCode &status)
+{
+    UChar pivot[CONVERTER_PIVOT_SIZE];
+    UChar *pivotSource = pivot, *pivotTarget = pivot;
+    bool flush = false;
+
+    reset(self);
+    reset(target);
+
+    while (!flush) {
+        size_t count = fread(inBuffer, 1, size, input);
+
+        if (count < size)
+        {
+            if (ferror(input))
+                return errno;
+            flush = true;
+        }
+
+        const char *source = inBuffer;
+
+        while (true) {
+            char *out = outBuffer;
+
+            ucnv_convertEx(target->object, self->object,
+                           &out, outBuffer + size,
+                           &source, inBuffer + count,
+                           pivot, &pivotSource, &pivotTarget,
+                           pivot + CONVERTER_PIVOT_SIZE,
+                           false, flush, &status);
+
+            size_t length = out - outBuffer;
+
+            if (length > 0 && fwrite(outBuffer, 1, length, output) < length)
+                return errno;
+            written += length;
+
+            if (status != U_BUFFER_OVERFLOW_ERROR)
+                break;
+            status = U_ZERO_ERROR;
+        }
+
+        if (U_FAILURE(status))
+        {
+            stopped = source - inBuffer;
+            return 0;
+        }
+
+        read += count;
+    }
+
+    return 0;
+}
+
+static PyObject *t_converter_convertFile(t_converter *self, PyObject *args)
+{
+    t_converter *target;
+    charsArg inputPath, outputPath;
+    int size = 65536;
+
+    switch (PyTuple_Size(args)) {
+      case 3:
+        if (!parseArgs(args, "Off", &ConverterType_, &target,
+                       &inputPath, &outputPath) && target != self)
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "convertFile", args);
+      case 4:
+        if (!parseArgs(args, "Offi", &ConverterType_, &target,
+                       &inputPath, &outputPath, &size) &&
+            target != self && size > 0)
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "convertFile", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "convertFile", args);
+    }
+
+    FILE *input = fopen(inputPath, "rb");
+
+    if (input == NULL)
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, inputPath);
+
+    FILE *output = fopen(outputPath, "wb");
+
+    if (output == NULL)
+    {
+        fclose(input);
+        return PyErr_SetFromErrnoWithFilename(PyExc_IOError, outputPath);
+    }
+
+    char *buffers = (char *) malloc((size_t) size * 2);
+
+    if (buffers == NULL)
+    {
+        fclose(output);
+        fclose(input);
+        return PyErr_NoMemory();
+    }
+
+    // in address order, so that a.convert(b) and b.convert(a) can't deadlock
+    ObjectLocker firstLocker(self < target ? self->lock : target->lock);
+    ObjectLocker secondLocker(self < target ? target->lock : self->lock);
+    Py_ssize_t read = 0, written = 0, stopped = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    int error;
+
+    self->error = target->error = U_ZERO_ERROR;
+    Py_BEGIN_ALLOW_THREADS;
+    error = convertFile(self, target, input, output,
+                        buffers, buffers + size, (size_t) size,
+                        read, written, stopped, status);
+    if (fclose(output) != 0 && error == 0 && U_SUCCESS(status))
+        error = errno;
+    fclose(input);
+    Py_END_ALLOW_THREADS;
+
+    PyObject *result;
+
+    if (error != 0)
+    {
+        errno = error;
+        reset(self);
+        reset(target);
+        result = PyErr_SetFromErrno(PyExc_IOError);
+    }
+    else if (U_FAILURE(status))
+        result = raiseConvertError(self, target, buffers, stopped, stopped,
+                                   read, status);
+    else
+        result = Py_BuildValue("(nn)", read, written);
+
+    free(buffers);
+
+    return result;
+}
+
+
 void _init_charset(PyObject *m)
 {
     CharsetMatchType_.tp_str = (reprfunc) t_charsetmatch_str;
 
     INSTALL_STRUCT(CharsetDetector, m);
     INSTALL_STRUCT(CharsetMatch, m);
+    INSTALL_STRUCT(Converter, m);
 }
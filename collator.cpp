@@ -63,9 +63,15 @@ DECLARE_TYPE(CollationKey, t_collationkey, UObject, CollationKey,
 
 /* Collator */
 
+/* The calls made without the GIL share lock, the setters wait on it for
+ * them to finish, so that the collator isn't modified while in use by other
+ * threads. It must follow object, RuleBasedCollator instances are also
+ * t_collator.
+ */
 class t_collator : public _wrapper {
 public:
     Collator *object;
+    SharedLock lock;
 };
 
 static PyObject *t_collator_compare(t_collator *self, PyObject *args);
@@ -74,6 +80,9 @@ static PyObject *t_collator_greaterOrEqual(t_collator *self, PyObject *args);
 static PyObject *t_collator_equals(t_collator *self, PyObject *args);
 static PyObject *t_collator_getCollationKey(t_collator *self, PyObject *args);
 static PyObject *t_collator_getSortKey(t_collator *self, PyObject *args);
+static PyObject *t_collator_getSortKeys(t_collator *self, PyObject *args);
+static PyObject *t_collator_sort(t_collator *self, PyObject *args);
+static PyObject *t_collator_argsort(t_collator *self, PyObject *args);
 static PyObject *t_collator_getStrength(t_collator *self);
 static PyObject *t_collator_setStrength(t_collator *self, PyObject *arg);
 static PyObject *t_collator_getLocale(t_collator *self, PyObject *args);
@@ -89,6 +98,17 @@ static PyObject *t_collator_getKeywordValues(PyTypeObject *type, PyObject *arg);
 static PyObject *t_collator_getFunctionalEquivalent(PyTypeObject *type,
                                                     PyObject *args);
 
+static void t_collator_dealloc(t_collator *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 static PyMethodDef t_collator_methods[] = {
     DECLARE_METHOD(t_collator, compare, METH_VARARGS),
     DECLARE_METHOD(t_collator, greater, METH_VARARGS),
@@ -96,6 +116,9 @@ static PyMethodDef t_collator_methods[] = {
     DECLARE_METHOD(t_collator, equals, METH_VARARGS),
     DECLARE_METHOD(t_collator, getCollationKey, METH_VARARGS),
     DECLARE_METHOD(t_collator, getSortKey, METH_VARARGS),
+    DECLARE_METHOD(t_collator, getSortKeys, METH_VARARGS),
+    DECLARE_METHOD(t_collator, sort, METH_VARARGS),
+    DECLARE_METHOD(t_collator, argsort, METH_VARARGS),
     DECLARE_METHOD(t_collator, getStrength, METH_NOARGS),
     DECLARE_METHOD(t_collator, setStrength, METH_O),
     DECLARE_METHOD(t_collator, getLocale, METH_VARARGS),
@@ -112,13 +135,15 @@ static PyMethodDef t_collator_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
-DECLARE_TYPE(Collator, t_collator, UObject, Collator, abstract_init, NULL)
+DECLARE_TYPE(Collator, t_collator, UObject, Collator, abstract_init,
+             t_collator_dealloc)
 
 /* RuleBasedCollator */
 
 class t_rulebasedcollator : public _wrapper {
 public:
     RuleBasedCollator *object;
+    SharedLock lock;
     PyObject *buf;
     PyObject *base;
 };
@@ -145,6 +170,7 @@ static void t_rulebasedcollator_dealloc(t_rulebasedcollator *self)
 
     Py_CLEAR(self->buf);
     Py_CLEAR(self->base);
+    self->lock.free();
 
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
@@ -432,14 +458,22 @@ static PyObject *t_collator_compare(t_collator *self, PyObject *args)
       case 2:
         if (!parseArgs(args, "SS", &u, &_u, &v, &_v))
         {
-            STATUS_CALL(result = self->object->compare(*u, *v, status));
+            SharedLocker locker(self->lock);
+
+            STATUS_ALLOW_THREADS_CALL(
+                locker.shared && allowThreads(u, &_u, v, &_v),
+                result = self->object->compare(*u, *v, status));
             return PyInt_FromLong(result);
         }
         break;
       case 3:
         if (!parseArgs(args, "SSi", &u, &_u, &v, &_v, &len))
         {
-            STATUS_CALL(result = self->object->compare(*u, *v, len, status));
+            SharedLocker locker(self->lock);
+
+            STATUS_ALLOW_THREADS_CALL(
+                locker.shared && allowThreads(u, &_u, v, &_v),
+                result = self->object->compare(*u, *v, len, status));
             return PyInt_FromLong(result);
         }
         break;
@@ -456,7 +490,10 @@ static PyObject *t_collator_greater(t_collator *self, PyObject *args)
 
     if (!parseArgs(args, "SS", &u, &_u, &v, &_v))
     {
-        b = self->object->greater(*u, *v);
+        SharedLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(locker.shared && allowThreads(u, &_u, v, &_v),
+                           b = self->object->greater(*u, *v));
         Py_RETURN_BOOL(b);
     }
 
@@ -471,7 +508,10 @@ static PyObject *t_collator_greaterOrEqual(t_collator *self, PyObject *args)
 
     if (!parseArgs(args, "SS", &u, &_u, &v, &_v))
     {
-        b = self->object->greaterOrEqual(*u, *v);
+        SharedLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(locker.shared && allowThreads(u, &_u, v, &_v),
+                           b = self->object->greaterOrEqual(*u, *v));
         Py_RETURN_BOOL(b);
     }
 
@@ -486,7 +526,10 @@ static PyObject *t_collator_equals(t_collator *self, PyObject *args)
 
     if (!parseArgs(args, "SS", &u, &_u, &v, &_v))
     {
-        b = self->object->equals(*u, *v);
+        SharedLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(locker.shared && allowThreads(u, &_u, v, &_v),
+                           b = self->object->equals(*u, *v));
         Py_RETURN_BOOL(b);
     }
 
@@ -504,7 +547,11 @@ static PyObject *t_collator_getCollationKey(t_collator *self, PyObject *args)
       case 1:
         if (!parseArgs(args, "S", &u, &_u))
         {
-            STATUS_CALL(self->object->getCollationKey(*u, _key, status));
+            SharedLocker locker(self->lock);
+
+            STATUS_ALLOW_THREADS_CALL(
+                locker.shared && allowThreads(u, &_u),
+                self->object->getCollationKey(*u, _key, status));
             return wrap_CollationKey(new CollationKey(_key), T_OWNED);
         }
         break;
@@ -533,13 +580,16 @@ static PyObject *t_collator_getSortKey(t_collator *self, PyObject *args)
       case 1:
         if (!parseArgs(args, "S", &u, &_u))
         {
+            SharedLocker locker(self->lock);
+
             len = u->length() * 4 + 8;
             buf = (uint8_t *) malloc(len);
           retry:
             if (buf == NULL)
                 return PyErr_NoMemory();
 
-            size = self->object->getSortKey(*u, buf, len);
+            ALLOW_THREADS_CALL(locker.shared && allowThreads(u, &_u),
+                               size = self->object->getSortKey(*u, buf, len));
             if (size <= len)
             {
                 key = PyBytes_FromStringAndSize((char *) buf, size);
@@ -562,7 +612,10 @@ static PyObject *t_collator_getSortKey(t_collator *self, PyObject *args)
             if (buf == NULL)
                 return PyErr_NoMemory();
 
-            len = self->object->getSortKey(*u, buf, len);
+            SharedLocker locker(self->lock);
+
+            ALLOW_THREADS_CALL(locker.shared && allowThreads(u, &_u),
+                               len = self->object->getSortKey(*u, buf, len));
             key = PyBytes_FromStringAndSize((char *) buf, len);
             free(buf);
 
@@ -574,6 +627,308 @@ static PyObject *t_collator_getSortKey(t_collator *self, PyObject *args)
     return PyErr_SetArgsError((PyObject *) self, "getSortKey", args);
 }
 
+/* Computes the sort keys of count strings into one malloc'ed buffer, the
+ * key of strings[i] spans offsets[i] to offsets[i + 1]. Returns NULL when
+ * out of memory. Doesn't use the GIL.
+ */
+static uint8_t *getSortKeys(const Collator *collator,
+                            const UnicodeString *strings, int count,
+                            int64_t *offsets)
+{
+    size_t len = 1024, size = 0;
+    uint8_t *buf = (uint8_t *) malloc(len);
+
+    if (buf == NULL)
+        return NULL;
+
+    for (int i = 0; i < count; i++) {
+        size_t needed = size + strings[i].length() * 4 + 8;
+
+        offsets[i] = size;
+
+        while (true) {
+            if (needed > len)
+            {
+                uint8_t *resized;
+
+                len = needed > len * 2 ? needed : len * 2;
+                resized = (uint8_t *) realloc(buf, len);
+                if (resized == NULL)
+                {
+                    free(buf);
+                    return NULL;
+                }
+                buf = resized;
+            }
+
+            int32_t keyLen = collator->getSortKey(
+                strings[i], buf + size, (int32_t) (len - size));
+
+            needed = size + keyLen;
+            if (needed <= len)
+                break;
+        }
+
+        size = needed;
+    }
+    offsets[count] = size;
+
+    return buf;
+}
+
+static int countLength(const UnicodeString *strings, int count)
+{
+    int32_t length = 0;
+
+    for (int i = 0; i < count && length < ALLOW_THREADS_MIN_LENGTH; i++)
+        length += strings[i].length();
+
+    return length;
+}
+
+/* Converts a sequence, or any other iterable, of strings. Returns a new
+ * reference to the sequence, or to a list of the iterable's items, NULL
+ * with an error set if a conversion failed, NULL without an error if arg
+ * is not of the expected type.
+ */
+static PyObject *toStrings(PyObject *arg, UnicodeString **strings, int *count)
+{
+    PyObject *seq;
+
+    if (PyBytes_Check(arg) || PyUnicode_Check(arg) || isUnicodeString(arg))
+        return NULL;
+
+    if (PySequence_Check(arg))
+    {
+        Py_INCREF(arg);
+        seq = arg;
+    }
+    else if (Py_TYPE(arg)->tp_iter != NULL)
+    {
+        seq = PySequence_List(arg);
+        if (seq == NULL)
+            return NULL;
+    }
+    else
+        return NULL;
+
+    if (parseArg(seq, "T", strings, count))
+    {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    return seq;
+}
+
+static PyObject *t_collator_getSortKeys(t_collator *self, PyObject *args)
+{
+    PyObject *seq, *result;
+    UnicodeString *strings;
+    int count, packed = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 2:
+        packed = PyObject_IsTrue(PyTuple_GET_ITEM(args, 1));
+        if (packed < 0)
+            return NULL;
+        /* fall through */
+      case 1:
+        seq = toStrings(PyTuple_GET_ITEM(args, 0), &strings, &count);
+        if (seq != NULL)
+            break;
+        if (PyErr_Occurred())
+            return NULL;
+        /* fall through */
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "getSortKeys", args);
+    }
+    Py_DECREF(seq);
+
+    int64_t *offsets = new int64_t[count + 1];
+    uint8_t *buf;
+
+    {
+        SharedLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(
+            locker.shared && allowThreads(countLength(strings, count)),
+            buf = getSortKeys(self->object, strings, count, offsets));
+    }
+    delete[] strings;
+
+    if (buf == NULL)
+    {
+        delete[] offsets;
+        return PyErr_NoMemory();
+    }
+
+    if (packed)
+    {
+        result = Py_BuildValue(
+            "(NN)",
+            PyBytes_FromStringAndSize((char *) buf, offsets[count]),
+            PyBytes_FromStringAndSize((char *) offsets,
+                                      sizeof(int64_t) * (count + 1)));
+    }
+    else
+    {
+        result = PyList_New(count);
+
+        for (int i = 0; result != NULL && i < count; i++) {
+            PyObject *key = PyBytes_FromStringAndSize(
+                (char *) buf + offsets[i], offsets[i + 1] - offsets[i]);
+
+            if (key == NULL)
+                Py_CLEAR(result);
+            else
+                PyList_SET_ITEM(result, i, key);
+        }
+    }
+
+    free(buf);
+    delete[] offsets;
+
+    return result;
+}
+
+struct sortEntry {
+    const char *key;
+    int index;
+};
+
+/* Sort keys are NUL-terminated and contain no other NUL byte, ties are
+ * broken on index to keep the sort stable.
+ */
+static int compareSortEntries(const void *a, const void *b)
+{
+    const sortEntry *e0 = (const sortEntry *) a;
+    const sortEntry *e1 = (const sortEntry *) b;
+    int result = strcmp(e0->key, e1->key);
+
+    if (result == 0)
+        return e0->index < e1->index ? -1 : e0->index > e1->index;
+
+    return result;
+}
+
+static int compareSortEntriesReversed(const void *a, const void *b)
+{
+    const sortEntry *e0 = (const sortEntry *) a;
+    const sortEntry *e1 = (const sortEntry *) b;
+    int result = strcmp(e1->key, e0->key);
+
+    if (result == 0)
+        return e0->index < e1->index ? -1 : e0->index > e1->index;
+
+    return result;
+}
+
+/* Returns the new[]'ed array of the indices of strings in sort order, NULL
+ * when out of memory. Doesn't use the GIL.
+ */
+static int *sortStrings(const Collator *collator,
+                        const UnicodeString *strings, int count, bool reverse)
+{
+    int64_t *offsets = new int64_t[count + 1];
+    uint8_t *buf = getSortKeys(collator, strings, count, offsets);
+
+    if (buf == NULL)
+    {
+        delete[] offsets;
+        return NULL;
+    }
+
+    sortEntry *entries = new sortEntry[count + 1];
+
+    for (int i = 0; i < count; i++) {
+        entries[i].key = (const char *) buf + offsets[i];
+        entries[i].index = i;
+    }
+    qsort(entries, count, sizeof(sortEntry),
+          reverse ? compareSortEntriesReversed : compareSortEntries);
+
+    int *indices = new int[count + 1];
+
+    for (int i = 0; i < count; i++)
+        indices[i] = entries[i].index;
+
+    delete[] entries;
+    delete[] offsets;
+    free(buf);
+
+    return indices;
+}
+
+static PyObject *t_collator_sortStrings(t_collator *self, PyObject *args,
+                                        const char *name, bool items)
+{
+    PyObject *seq, *result;
+    UnicodeString *strings;
+    int count, reverse = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 2:
+        reverse = PyObject_IsTrue(PyTuple_GET_ITEM(args, 1));
+        if (reverse < 0)
+            return NULL;
+        /* fall through */
+      case 1:
+        seq = toStrings(PyTuple_GET_ITEM(args, 0), &strings, &count);
+        if (seq != NULL)
+            break;
+        if (PyErr_Occurred())
+            return NULL;
+        /* fall through */
+      default:
+        return PyErr_SetArgsError((PyObject *) self, name, args);
+    }
+
+    int *indices;
+
+    {
+        SharedLocker locker(self->lock);
+
+        ALLOW_THREADS_CALL(
+            locker.shared && allowThreads(countLength(strings, count)),
+            indices = sortStrings(self->object, strings, count, reverse));
+    }
+    delete[] strings;
+
+    if (indices == NULL)
+    {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    result = PyList_New(count);
+    for (int i = 0; result != NULL && i < count; i++) {
+        PyObject *item = items
+            ? PySequence_GetItem(seq, indices[i])
+            : PyInt_FromLong(indices[i]);
+
+        if (item == NULL)
+            Py_CLEAR(result);
+        else
+            PyList_SET_ITEM(result, i, item);
+    }
+
+    delete[] indices;
+    Py_DECREF(seq);
+
+    return result;
+}
+
+static PyObject *t_collator_sort(t_collator *self, PyObject *args)
+{
+    return t_collator_sortStrings(self, args, "sort", true);
+}
+
+static PyObject *t_collator_argsort(t_collator *self, PyObject *args)
+{
+    return t_collator_sortStrings(self, args, "argsort", false);
+}
+
 static PyObject *t_collator_getStrength(t_collator *self)
 {
     return PyInt_FromLong(self->object->getStrength());
@@ -585,6 +940,8 @@ static PyObject *t_collator_setStrength(t_collator *self, PyObject *arg)
 
     if (!parseArg(arg, "i", &strength))
     {
+        self->lock.acquireExclusive();
+
         self->object->setStrength(strength);
         Py_RETURN_NONE;
     }
@@ -727,6 +1084,8 @@ static PyObject *t_collator_setAttribute(t_collator *self, PyObject *args)
 
     if (!parseArgs(args, "ii", &attribute, &value))
     {
+        self->lock.acquireExclusive();
+
         STATUS_CALL(self->object->setAttribute(attribute, value, status));
         Py_RETURN_NONE;
     }
@@ -757,11 +1116,15 @@ static PyObject *t_collator_setVariableTop(t_collator *self, PyObject *arg)
 
     if (!parseArg(arg, "i", &top))
     {
+        self->lock.acquireExclusive();
+
         STATUS_CALL(self->object->setVariableTop(top << 16, status));
         Py_RETURN_NONE;
     }
     else if (!parseArg(arg, "S", &u, &_u))
     {
+        self->lock.acquireExclusive();
+
         STATUS_CALL(self->object->setVariableTop(*u, status)); /* transient */
         Py_RETURN_NONE;
     }
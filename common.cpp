@@ -30,12 +30,17 @@
 #include <unicode/ustring.h>
 #include <unicode/utf16.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PYICU_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "bases.h"
+#include "tzinfo.h"
 #include "macros.h"
 
 static PyObject *utcoffset_NAME;
-static PyObject *toordinal_NAME;
-static PyObject *getDefault_NAME;
 
 
 typedef struct {
@@ -155,6 +160,110 @@ EXPORT PyObject *ICUException::reportError()
 }
 
 
+/* Conversion kernels between python's fixed width string storage and
+ * UTF-16. The SSE2 versions are part of every x86-64 build, the plain loops
+ * are otherwise left to the compiler to vectorize.
+ */
+
+static inline void widenLatin1(const Py_UCS1 *src, UChar *dest,
+                               Py_ssize_t len)
+{
+    Py_ssize_t i = 0;
+
+#ifdef PYICU_SSE2
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (src + i));
+
+        _mm_storeu_si128((__m128i *) (dest + i),
+                         _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128((__m128i *) (dest + i + 8),
+                         _mm_unpackhi_epi8(bytes, zero));
+    }
+#endif
+
+    for (; i < len; ++i)
+        dest[i] = (UChar) src[i];
+}
+
+// all of src must be below 0x100
+static inline void narrowLatin1(const UChar *src, Py_UCS1 *dest,
+                                Py_ssize_t len)
+{
+    Py_ssize_t i = 0;
+
+#ifdef PYICU_SSE2
+    for (; i + 16 <= len; i += 16) {
+        __m128i lo = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *) (src + i + 8));
+
+        _mm_storeu_si128((__m128i *) (dest + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < len; ++i)
+        dest[i] = (Py_UCS1) src[i];
+}
+
+// the bitwise or of all code units, enough to pick a python string kind
+static inline UChar orUTF16(const UChar *src, Py_ssize_t len)
+{
+    Py_ssize_t i = 0;
+    UChar bits = 0;
+
+#ifdef PYICU_SSE2
+    __m128i acc = _mm_setzero_si128();
+
+    for (; i + 8 <= len; i += 8)
+        acc = _mm_or_si128(acc, _mm_loadu_si128((const __m128i *) (src + i)));
+
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 2));
+    bits = (UChar) _mm_cvtsi128_si32(acc);
+#endif
+
+    for (; i < len; ++i)
+        bits |= src[i];
+
+    return bits;
+}
+
+static inline Py_ssize_t countSupplementary(const Py_UCS4 *src,
+                                            Py_ssize_t len)
+{
+    Py_ssize_t i = 0, count = 0;
+
+#ifdef PYICU_SSE2
+    const __m128i zero = _mm_setzero_si128();
+
+    while (i + 4 <= len) {
+        // chunked so that the 32-bit lane counters cannot overflow
+        Py_ssize_t end = len - i > 0x10000 ? i + 0x10000 : len;
+        __m128i acc = zero;
+
+        for (; i + 4 <= end; i += 4) {
+            __m128i chars = _mm_loadu_si128((const __m128i *) (src + i));
+            __m128i bmp = _mm_cmpeq_epi32(_mm_srli_epi32(chars, 16), zero);
+
+            // bmp lanes are -1, others 0
+            acc = _mm_add_epi32(acc, _mm_add_epi32(bmp, _mm_set1_epi32(1)));
+        }
+
+        acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+        acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+        count += _mm_cvtsi128_si32(acc);
+    }
+#endif
+
+    for (; i < len; ++i)
+        count += src[i] > 0xffff;
+
+    return count;
+}
+
+
 EXPORT PyObject *PyUnicode_FromUnicodeString(const UnicodeString *string)
 {
     if (!string)
@@ -199,15 +308,22 @@ EXPORT PyObject *PyUnicode_FromUnicodeString(const UChar *utf16, int len16)
     }
 #else
     {
-        int32_t len32 = 0;
-        UChar32 max_char = 0;
+        int32_t len32 = len16;
+        UChar32 max_char = orUTF16(utf16, len16);
+
+        // without any surrogates, all code points are code units
+        if (max_char >= 0xd800)
+        {
+            len32 = 0;
+            max_char = 0;
 
-        for (int32_t i = 0; i < len16;) {
-            UChar32 cp;
+            for (int32_t i = 0; i < len16;) {
+                UChar32 cp;
 
-            U16_NEXT(utf16, i, len16, cp);
-            max_char |= cp;  // we only care about the leftmost bit
-            len32 += 1;
+                U16_NEXT(utf16, i, len16, cp);
+                max_char |= cp;  // we only care about the leftmost bit
+                len32 += 1;
+            }
         }
 
         PyObject *result = PyUnicode_New(len32, max_char);
@@ -218,8 +334,7 @@ EXPORT PyObject *PyUnicode_FromUnicodeString(const UChar *utf16, int len16)
         switch (PyUnicode_KIND(result)) {
           case PyUnicode_1BYTE_KIND:
             // note: len16 == len32
-            for (int32_t i = 0; i < len32; ++i)
-                PyUnicode_1BYTE_DATA(result)[i] = (Py_UCS1) (utf16[i]);
+            narrowLatin1(utf16, PyUnicode_1BYTE_DATA(result), len32);
             break;
 
           case PyUnicode_2BYTE_KIND:
@@ -251,49 +366,199 @@ EXPORT PyObject *PyUnicode_FromUnicodeString(const UChar *utf16, int len16)
 #endif
 }
 
+/* Converters are expensive to open so a few are kept around, keyed by the
+ * encoding name they were requested with. A converter is removed from the
+ * cache while in use. The GIL protects the cache.
+ */
+
+#define CONVERTER_CACHE_SIZE 8
+
+static struct {
+    char *encoding;
+    UConverter *conv;
+} converters[CONVERTER_CACHE_SIZE];
+static int nextConverter = 0;
+
+static UConverter *openConverter(const char *encoding, UErrorCode &status)
+{
+    for (int i = 0; i < CONVERTER_CACHE_SIZE; ++i) {
+        if (converters[i].conv != NULL &&
+            !strcmp(converters[i].encoding, encoding))
+        {
+            UConverter *conv = converters[i].conv;
+
+            converters[i].conv = NULL;
+            ucnv_reset(conv);
+
+            return conv;
+        }
+    }
+
+    return ucnv_open(encoding, &status);
+}
+
+static void closeConverter(const char *encoding, UConverter *conv)
+{
+    int slot = -1;
+
+    for (int i = 0; i < CONVERTER_CACHE_SIZE; ++i) {
+        if (converters[i].encoding == NULL ||
+            (converters[i].conv == NULL &&
+             !strcmp(converters[i].encoding, encoding)))
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0)
+    {
+        slot = nextConverter;
+        nextConverter = (nextConverter + 1) % CONVERTER_CACHE_SIZE;
+
+        if (converters[slot].conv != NULL)
+            ucnv_close(converters[slot].conv);
+    }
+
+    if (converters[slot].encoding == NULL ||
+        strcmp(converters[slot].encoding, encoding))
+    {
+        char *copy = strdup(encoding);
+
+        if (copy == NULL)
+        {
+            ucnv_close(conv);
+            converters[slot].conv = NULL;
+            return;
+        }
+
+        free(converters[slot].encoding);
+        converters[slot].encoding = copy;
+    }
+
+    converters[slot].conv = conv;
+}
+
+static bool isASCII(const char *src, Py_ssize_t len)
+{
+    unsigned char bits = 0;
+
+    for (Py_ssize_t i = 0; i < len; ++i)
+        bits |= (unsigned char) src[i];
+
+    return bits < 0x80;
+}
+
 EXPORT UnicodeString &PyBytes_AsUnicodeString(PyObject *object,
                                               const char *encoding,
                                               const char *mode,
                                               UnicodeString &string)
 {
     UErrorCode status = U_ZERO_ERROR;
-    UConverter *conv = ucnv_open(encoding, &status);
+    char *src;
+    Py_ssize_t len;
+
+    PyBytes_AsStringAndSize(object, &src, &len);
+
+    // valid ASCII or UTF-8 decodes the same in every mode
+    const bool utf8 = !ucnv_compareNames(encoding, "utf-8");
+
+    if (utf8 || !ucnv_compareNames(encoding, "ascii") ||
+        !ucnv_compareNames(encoding, "us-ascii"))
+    {
+        if (isASCII(src, len))
+        {
+            UChar *chars = string.getBuffer((int32_t) len);
+
+            if (chars == NULL)
+            {
+                PyErr_NoMemory();
+                throw ICUException();
+            }
+
+            widenLatin1((const Py_UCS1 *) src, chars, len);
+            string.releaseBuffer((int32_t) len);
+
+            return string;
+        }
+
+        if (utf8)
+        {
+            UChar *chars = string.getBuffer((int32_t) len);
+            int32_t size = 0;
+
+            if (chars == NULL)
+            {
+                PyErr_NoMemory();
+                throw ICUException();
+            }
+
+            u_strFromUTF8(chars, (int32_t) len, &size, src, (int32_t) len,
+                          &status);
+            if (U_SUCCESS(status))
+            {
+                string.releaseBuffer(size);
+                return string;
+            }
+
+            // let the converter report or substitute the invalid bytes
+            string.releaseBuffer(0);
+            status = U_ZERO_ERROR;
+        }
+    }
+
+    UConverter *conv = openConverter(encoding, status);
 
     if (U_FAILURE(status))
         throw ICUException(status);
 
     _STOPReason stop;
-    char *src;
-    Py_ssize_t len;
-    UChar *buffer, *target;
 
     memset(&stop, 0, sizeof(stop));
+    stop.src = src;
+    stop.src_length = (int) len;
 
     if (!strcmp(mode, "strict"))
-    {
         ucnv_setToUCallBack(conv, _stopDecode, &stop, NULL, NULL, &status);
-        if (U_FAILURE(status))
+    else
+        ucnv_setToUCallBack(conv, UCNV_TO_U_CALLBACK_SUBSTITUTE, NULL,
+                            NULL, NULL, &status);
+
+    if (U_FAILURE(status))
+    {
+        ucnv_close(conv);
+        throw ICUException(status);
+    }
+
+    const char *source = src;
+    int32_t capacity = (int32_t) len;
+    int32_t size = 0;
+
+    // a byte may decode to more than one UChar, grow the buffer as needed
+    while (true) {
+        UChar *buffer = string.getBuffer(capacity);
+
+        if (buffer == NULL)
         {
             ucnv_close(conv);
-            throw ICUException(status);
+
+            PyErr_NoMemory();
+            throw ICUException();
         }
-    }
 
-    PyBytes_AsStringAndSize(object, &src, &len);
-    stop.src = src;
-    stop.src_length = (int) len;
+        UChar *target = buffer + size;
 
-    buffer = target = new UChar[(int) len];
-    if (buffer == NULL)
-    {
-        ucnv_close(conv);
+        ucnv_toUnicode(conv, &target, buffer + capacity,
+                       &source, src + len, NULL, true, &status);
+        size = (int32_t) (target - buffer);
+        string.releaseBuffer(size);
 
-        PyErr_NoMemory();
-        throw ICUException();
-    }
+        if (status != U_BUFFER_OVERFLOW_ERROR)
+            break;
 
-    ucnv_toUnicode(conv, &target, target + (int) len,
-                   (const char **) &src, src + len, NULL, true, &status);
+        status = U_ZERO_ERROR;
+        capacity = capacity * 2 + 16;
+    }
 
     if (U_FAILURE(status))
     {
@@ -317,16 +582,13 @@ EXPORT UnicodeString &PyBytes_AsUnicodeString(PyObject *object,
 
         PyErr_Format(PyExc_ValueError, "'%s' codec can't decode byte 0x%x in position %d: reason code %d (%s)", ucnv_getName(conv, &status), (int) (unsigned char) stop.chars[0], stop.error_position, stop.reason, reasonName);
 
-        delete[] buffer;
+        string.remove();
         ucnv_close(conv);
 
         throw ICUException();
     }
 
-    string.setTo(buffer, (int32_t) (target - buffer));
-
-    delete[] buffer;
-    ucnv_close(conv);
+    closeConverter(encoding, conv);
 
     return string;
 }
@@ -389,8 +651,7 @@ EXPORT UnicodeString &PyObject_AsUnicodeString(PyObject *object,
 
               if (chars != NULL)
               {
-                  for (int i = 0; i < len; ++i)
-                      chars[i] = (UChar) pchars[i];
+                  widenLatin1(pchars, chars, len);
                   string.releaseBuffer(len);
               }
               break;
@@ -407,8 +668,19 @@ EXPORT UnicodeString &PyObject_AsUnicodeString(PyObject *object,
           case PyUnicode_4BYTE_KIND: {
               Py_ssize_t len = PyUnicode_GET_LENGTH(object);
               Py_UCS4 *pchars = PyUnicode_4BYTE_DATA(object);
+              // at least one char is outside the BMP or kind would be 2
+              Py_ssize_t size = len + countSupplementary(pchars, len);
+
+              UChar *chars = string.getBuffer((int32_t) size);
+
+              if (chars != NULL)
+              {
+                  int32_t j = 0;
 
-              string = UnicodeString::fromUTF32((const UChar32 *) pchars, len);
+                  for (int i = 0; i < len; ++i)
+                      U16_APPEND_UNSAFE(chars, j, pchars[i]);
+                  string.releaseBuffer(j);
+              }
               break;
           }
         }
@@ -431,6 +703,39 @@ EXPORT UnicodeString &PyObject_AsUnicodeString(PyObject *object,
     return PyObject_AsUnicodeString(object, "utf-8", "strict", string);
 }
 
+/* Like PyObject_AsUnicodeString() but when the python string is already
+ * stored as UTF-16 the UnicodeString is made a read-only alias of it
+ * instead of a copy. The python string must outlive the UnicodeString, as
+ * call arguments do.
+ */
+EXPORT UnicodeString &PyObject_AsUnicodeStringAlias(PyObject *object,
+                                                    UnicodeString &string)
+{
+    if (PyUnicode_Check(object))
+    {
+#if PY_VERSION_HEX < 0x03030000
+        if (sizeof(Py_UNICODE) == sizeof(UChar))
+        {
+            // python strings are NUL-terminated
+            string.setTo(true, (const UChar *) PyUnicode_AS_UNICODE(object),
+                         (int32_t) PyUnicode_GET_SIZE(object));
+            return string;
+        }
+#else
+        if (PyUnicode_READY(object) == 0 &&
+            PyUnicode_KIND(object) == PyUnicode_2BYTE_KIND)
+        {
+            // python strings are NUL-terminated
+            string.setTo(true, (const UChar *) PyUnicode_2BYTE_DATA(object),
+                         (int32_t) PyUnicode_GET_LENGTH(object));
+            return string;
+        }
+#endif
+    }
+
+    return PyObject_AsUnicodeString(object, string);
+}
+
 EXPORT UnicodeString *PyObject_AsUnicodeString(PyObject *object)
 {
     if (object == Py_None)
@@ -447,37 +752,442 @@ EXPORT UnicodeString *PyObject_AsUnicodeString(PyObject *object)
 
         return new UnicodeString(string);
     }
-}
+}
+
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+
+/* A UText over the PEP 393 storage of a python str, read in place. Native
+ * indexes are code point indexes. UCS-2 strings are handed to ICU as a
+ * single chunk, Latin-1 and UCS-4 strings are widened to UTF-16 one chunk
+ * at a time into the UText's extra space.
+ *
+ *   ut->context  the str, not referenced
+ *   ut->p        its data
+ *   ut->a        its length
+ *   ut->b        its kind
+ */
+
+#define PYTHON_TEXT_CHUNK_SIZE 256  /* code points */
+
+static int32_t pythonTextUTF16Offset(const UText *ut, int64_t index)
+{
+    int32_t offset = (int32_t) (index - ut->chunkNativeStart);
+
+    if (offset <= ut->nativeIndexingLimit)
+        return offset;
+
+    // walk from the first supplementary code point of the chunk
+    const UChar *chars = ut->chunkContents;
+    int32_t count = offset - ut->nativeIndexingLimit;
+
+    offset = ut->nativeIndexingLimit;
+    while (count-- > 0 && offset < ut->chunkLength)
+        U16_FWD_1(chars, offset, ut->chunkLength);
+
+    return offset;
+}
+
+static void pythonTextFillChunk(UText *ut, int64_t start)
+{
+    int64_t limit = start + PYTHON_TEXT_CHUNK_SIZE;
+    UChar *chars = (UChar *) ut->pExtra;
+    int32_t length = 0, indexingLimit = -1;
+
+    if (limit > ut->a)
+        limit = ut->a;
+
+    if (ut->b == PyUnicode_1BYTE_KIND)
+    {
+        const Py_UCS1 *data = (const Py_UCS1 *) ut->p + start;
+
+        for (int64_t i = start; i < limit; ++i)
+            chars[length++] = *data++;
+    }
+    else
+    {
+        const Py_UCS4 *data = (const Py_UCS4 *) ut->p + start;
+
+        for (int64_t i = start; i < limit; ++i) {
+            Py_UCS4 c = *data++;
+
+            if (c > 0xffff)
+            {
+                if (indexingLimit < 0)
+                    indexingLimit = length;
+                chars[length++] = U16_LEAD(c);
+                chars[length++] = U16_TRAIL(c);
+            }
+            else  // a lone surrogate is one code point in python
+                chars[length++] = U16_IS_SURROGATE(c) ? 0xfffd : (UChar) c;
+        }
+    }
+
+    ut->chunkContents = chars;
+    ut->chunkLength = length;
+    ut->chunkNativeStart = start;
+    ut->chunkNativeLimit = limit;
+    ut->nativeIndexingLimit = indexingLimit < 0 ? length : indexingLimit;
+}
+
+static UBool U_CALLCONV pythonTextAccess(UText *ut, int64_t index,
+                                         UBool forward)
+{
+    int64_t length = ut->a;
+
+    if (index < 0)
+        index = 0;
+    else if (index > length)
+        index = length;
+
+    if (ut->b != PyUnicode_2BYTE_KIND &&
+        !(forward ? (index >= ut->chunkNativeStart &&
+                     index < ut->chunkNativeLimit)
+                  : (index > ut->chunkNativeStart &&
+                     index <= ut->chunkNativeLimit)))
+    {
+        // chunks are aligned, the one before the end is the last one
+        int64_t block = forward ? index : index - 1;
+
+        if (block >= length)
+            block = length - 1;
+        if (block < 0)
+            block = 0;
+        pythonTextFillChunk(
+            ut, block - block % PYTHON_TEXT_CHUNK_SIZE);
+    }
+
+    ut->chunkOffset = pythonTextUTF16Offset(ut, index);
+
+    return forward ? index < length : index > 0;
+}
+
+static UText * U_CALLCONV pythonTextClone(UText *dest, const UText *src,
+                                          UBool deep, UErrorCode *status)
+{
+    if (U_FAILURE(*status))
+        return dest;
+
+    if (deep)
+    {
+        *status = U_UNSUPPORTED_ERROR;
+        return dest;
+    }
+
+    dest = utext_setup(dest, src->extraSize, status);
+    if (U_FAILURE(*status))
+        return dest;
+
+    void *extra = dest->pExtra;
+    int32_t flags = dest->flags;
+    int32_t size = src->sizeOfStruct < dest->sizeOfStruct
+        ? src->sizeOfStruct : dest->sizeOfStruct;
+
+    memcpy(dest, src, size);
+    dest->pExtra = extra;
+    dest->flags = flags;
+
+    if (src->extraSize > 0)
+    {
+        memcpy(extra, src->pExtra, src->extraSize);
+        if (src->chunkContents == src->pExtra)
+            dest->chunkContents = (const UChar *) extra;
+    }
+
+    return dest;
+}
+
+static int64_t U_CALLCONV pythonTextNativeLength(UText *ut)
+{
+    return ut->a;
+}
+
+static int32_t U_CALLCONV pythonTextExtract(UText *ut, int64_t start,
+                                            int64_t limit, UChar *dest,
+                                            int32_t capacity,
+                                            UErrorCode *status)
+{
+    if (U_FAILURE(*status))
+        return 0;
+
+    if (capacity < 0 || (dest == NULL && capacity > 0) || start > limit)
+    {
+        *status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+
+    if (start < 0)
+        start = 0;
+    if (limit > ut->a)
+        limit = ut->a;
+
+    int32_t length = 0;
+
+    for (int64_t i = start; i < limit; ++i) {
+        Py_UCS4 c = PyUnicode_READ((int) ut->b, ut->p, i);
+
+        if (c > 0xffff)
+        {
+            if (length + 1 < capacity)
+            {
+                dest[length] = U16_LEAD(c);
+                dest[length + 1] = U16_TRAIL(c);
+            }
+            length += 2;
+        }
+        else
+        {
+            if (length < capacity)
+                dest[length] =
+                    U16_IS_SURROGATE(c) && ut->b == PyUnicode_4BYTE_KIND
+                    ? 0xfffd : (UChar) c;
+            length += 1;
+        }
+    }
+
+    pythonTextAccess(ut, limit, true);
+
+    if (length < capacity)
+        dest[length] = 0;
+    else if (length == capacity)
+        *status = U_STRING_NOT_TERMINATED_WARNING;
+    else
+        *status = U_BUFFER_OVERFLOW_ERROR;
+
+    return length;
+}
+
+static int64_t U_CALLCONV pythonTextMapOffsetToNative(const UText *ut)
+{
+    int32_t offset = ut->nativeIndexingLimit;
+    int64_t index = ut->chunkNativeStart + offset;
+
+    while (offset < ut->chunkOffset) {
+        U16_FWD_1(ut->chunkContents, offset, ut->chunkLength);
+        index += 1;
+    }
+
+    return index;
+}
+
+static int32_t U_CALLCONV pythonTextMapNativeIndexToUTF16(const UText *ut,
+                                                          int64_t index)
+{
+    return pythonTextUTF16Offset(ut, index);
+}
+
+static const UTextFuncs pythonTextFuncs = {
+    sizeof(UTextFuncs), 0, 0, 0,
+    pythonTextClone,
+    pythonTextNativeLength,
+    pythonTextAccess,
+    pythonTextExtract,
+    NULL,  /* replace */
+    NULL,  /* copy */
+    pythonTextMapOffsetToNative,
+    pythonTextMapNativeIndexToUTF16,
+    NULL,  /* close */
+    NULL, NULL, NULL
+};
+
+UText *openPythonText(UText *ut, PyObject *object, UErrorCode &status)
+{
+    if (U_FAILURE(status))
+        return ut;
+
+    if (!PyUnicode_Check(object) || PyUnicode_READY(object) < 0)
+    {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return ut;
+    }
+
+    int kind = PyUnicode_KIND(object);
+    int32_t extraSize = kind == PyUnicode_2BYTE_KIND
+        ? 0 : PYTHON_TEXT_CHUNK_SIZE * 2 * sizeof(UChar);
+
+    ut = utext_setup(ut, extraSize, &status);
+    if (U_FAILURE(status))
+        return ut;
+
+    ut->pFuncs = &pythonTextFuncs;
+    ut->providerProperties = 0;
+    ut->context = object;
+    ut->p = PyUnicode_DATA(object);
+    ut->a = PyUnicode_GET_LENGTH(object);
+    ut->b = kind;
+
+    if (kind == PyUnicode_2BYTE_KIND)
+    {
+        // already UTF-16, a lone surrogate pair is read as one code point
+        ut->chunkContents = (const UChar *) ut->p;
+        ut->chunkLength = (int32_t) ut->a;
+        ut->chunkNativeStart = 0;
+        ut->chunkNativeLimit = ut->a;
+        ut->nativeIndexingLimit = (int32_t) ut->a;
+        ut->chunkOffset = 0;
+    }
+    else
+    {
+        ut->chunkNativeStart = ut->chunkNativeLimit = -1;
+        pythonTextAccess(ut, 0, true);
+    }
+
+    return ut;
+}
+
+bool isPythonText(const UText *ut)
+{
+    return ut != NULL && ut->pFuncs == &pythonTextFuncs;
+}
+
+#endif
+
+
+#if PY_VERSION_HEX < 0x02040000
+    /* Replace some _CheckExact macros for Python < 2.4 since the actual
+     * datetime types are private until then.  This is ugly, but allows
+     * support for datetime objects in Python 2.3.
+     */
+    #include <string.h>
+
+    #undef PyDateTime_CheckExact
+    #define PyDateTime_CheckExact(op) \
+       (!strcmp(Py_TYPE(op)->tp_name, "datetime.datetime"))
+
+    #undef PyDelta_CheckExact
+    #define PyDelta_CheckExact(op) \
+       (!strcmp(Py_TYPE(op)->tp_name, "datetime.timedelta"))
+#endif
+
+
+int isDate(PyObject *object)
+{
+    if (PyFloat_CheckExact(object))
+        return 1;
+
+    return PyDateTime_CheckExact(object);
+}
+
+int isDateExact(PyObject *object)
+{
+    return PyDateTime_CheckExact(object);
+}
+
+int64_t daysFromCivil(int year, int month, int day)
+{
+    int64_t y = month <= 2 ? year - 1 : year;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+bool isNativeFormat(const Py_buffer *view, char code, int size)
+{
+    const char *format = view->format;
+
+    if (view->itemsize != size || format == NULL)
+        return false;
+
+    if (format[0] == '@' || format[0] == '=')
+        format += 1;
+
+    return format[0] == code && format[1] == '\0';
+}
+
+PyObject *toInt32View(PyObject *bytes)
+{
+    if (bytes == NULL)
+        return NULL;
+
+    PyObject *view = PyMemoryView_FromObject(bytes);
+
+    Py_DECREF(bytes);
+    if (view == NULL)
+        return NULL;
+
+    PyObject *result = PyObject_CallMethod(view, (char *) "cast", (char *) "s",
+                                           "i");
+    Py_DECREF(view);
+
+    return result;
+}
+
+static void packUTF8(const UnicodeString *strings, Py_ssize_t count,
+                     char *data, int64_t *offsets, UErrorCode &status)
+{
+    offsets[0] = 0;
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        int32_t length = 0;
+
+        // lone surrogates are replaced, like str.encode('utf-8', 'replace')
+        u_strToUTF8WithSub(data + offsets[i], strings[i].length() * 3,
+                           &length, strings[i].getBuffer(),
+                           strings[i].length(), 0xfffd, NULL, &status);
+        if (U_FAILURE(status))
+            return;
+
+        offsets[i + 1] = offsets[i] + length;
+    }
+}
+
+PyObject *fromUnicodeStrings(const UnicodeString *strings,
+                             Py_ssize_t count, int packed)
+{
+    if (!packed)
+    {
+        PyObject *result = PyList_New(count);
+
+        for (Py_ssize_t i = 0; result != NULL && i < count; ++i) {
+            PyObject *string = PyUnicode_FromUnicodeString(&strings[i]);
+
+            if (string == NULL)
+                Py_CLEAR(result);
+            else
+                PyList_SET_ITEM(result, i, string);
+        }
+
+        return result;
+    }
 
+    // a UTF-16 code unit never takes more than three bytes in UTF-8
+    int64_t capacity = 0;
 
-#if PY_VERSION_HEX < 0x02040000
-    /* Replace some _CheckExact macros for Python < 2.4 since the actual
-     * datetime types are private until then.  This is ugly, but allows
-     * support for datetime objects in Python 2.3.
-     */
-    #include <string.h>
+    for (Py_ssize_t i = 0; i < count; ++i)
+        capacity += (int64_t) strings[i].length() * 3;
 
-    #undef PyDateTime_CheckExact
-    #define PyDateTime_CheckExact(op) \
-       (!strcmp(Py_TYPE(op)->tp_name, "datetime.datetime"))
+    char *data = (char *) malloc(capacity > 0 ? (size_t) capacity : 1);
+    int64_t *offsets = (int64_t *) malloc(sizeof(int64_t) * (count + 1));
 
-    #undef PyDelta_CheckExact
-    #define PyDelta_CheckExact(op) \
-       (!strcmp(Py_TYPE(op)->tp_name, "datetime.timedelta"))
-#endif
+    if (data == NULL || offsets == NULL)
+    {
+        free(data);
+        free(offsets);
+        return PyErr_NoMemory();
+    }
 
+    UErrorCode status = U_ZERO_ERROR;
 
-int isDate(PyObject *object)
-{
-    if (PyFloat_CheckExact(object))
-        return 1;
+    ALLOW_THREADS_CALL(
+        allowThreads((int32_t) (capacity < INT32_MAX ? capacity : INT32_MAX)),
+        packUTF8(strings, count, data, offsets, status));
 
-    return PyDateTime_CheckExact(object);
-}
+    PyObject *result = NULL;
 
-int isDateExact(PyObject *object)
-{
-    return PyDateTime_CheckExact(object);
+    if (U_FAILURE(status))
+        ICUException(status).reportError();
+    else
+        result = Py_BuildValue(
+            "(NN)", PyBytes_FromStringAndSize(data, offsets[count]),
+            PyBytes_FromStringAndSize((char *) offsets,
+                                      sizeof(int64_t) * (count + 1)));
+
+    free(data);
+    free(offsets);
+
+    return result;
 }
 
 EXPORT UDate PyObject_AsUDate(PyObject *object)
@@ -488,46 +1198,30 @@ EXPORT UDate PyObject_AsUDate(PyObject *object)
     {
         if (PyDateTime_CheckExact(object))
         {
-            PyObject *tzinfo = PyObject_GetAttrString(object, "tzinfo");
-            PyObject *utcoffset, *ordinal;
-
-            if (tzinfo == Py_None)
-            {
-                PyObject *m = PyImport_ImportModule("icu");
-                PyObject *cls = PyObject_GetAttrString(m, "ICUtzinfo");
-
-                tzinfo = PyObject_CallMethodObjArgs(cls, getDefault_NAME, NULL);
-                Py_DECREF(cls);
-                Py_DECREF(m);
-
-                utcoffset = PyObject_CallMethodObjArgs(tzinfo, utcoffset_NAME,
-                                                       object, NULL);
-                Py_DECREF(tzinfo);
-            }
-            else
-            {
-                utcoffset = PyObject_CallMethodObjArgs(object, utcoffset_NAME,
-                                                       NULL);
-                Py_DECREF(tzinfo);
+            double seconds =
+                daysFromCivil(PyDateTime_GET_YEAR(object),
+                              PyDateTime_GET_MONTH(object),
+                              PyDateTime_GET_DAY(object)) * 86400.0 +
+                PyDateTime_DATE_GET_HOUR(object) * 3600.0 +
+                PyDateTime_DATE_GET_MINUTE(object) * 60.0 +
+                (double) PyDateTime_DATE_GET_SECOND(object) +
+                PyDateTime_DATE_GET_MICROSECOND(object) / 1e6;
+            int offset;
+
+            /* naive or ICU tzinfo, no python calls */
+            switch (t_tzinfo_getOffset(object, &offset)) {
+              case 1:
+                return (UDate) ((seconds - offset / 1000) * 1000.0);
+              case -1:
+                throw ICUException();
             }
 
-            ordinal = PyObject_CallMethodObjArgs(object, toordinal_NAME, NULL);
+            PyObject *utcoffset =
+                PyObject_CallMethodObjArgs(object, utcoffset_NAME, NULL);
 
-            if (utcoffset != NULL && PyDelta_CheckExact(utcoffset) &&
-                ordinal != NULL && PyInt_CheckExact(ordinal))
+            if (utcoffset != NULL && PyDelta_CheckExact(utcoffset))
             {
-#if PY_MAJOR_VERSION >= 3
-                double ordinalValue = PyLong_AsDouble(ordinal);
-#else
-                long ordinalValue = PyInt_AsLong(ordinal);
-#endif
-
-                double timestamp =
-                    (ordinalValue - 719163) * 86400.0 +
-                    PyDateTime_DATE_GET_HOUR(object) * 3600.0 +
-                    PyDateTime_DATE_GET_MINUTE(object) * 60.0 +
-                    (double) PyDateTime_DATE_GET_SECOND(object) +
-                    PyDateTime_DATE_GET_MICROSECOND(object) / 1e6 -
+                seconds -=
 #ifndef PYPY_VERSION
                     (((PyDateTime_Delta *) utcoffset)->days * 86400.0 +
                      (double) ((PyDateTime_Delta *) utcoffset)->seconds);
@@ -539,13 +1233,11 @@ EXPORT UDate PyObject_AsUDate(PyObject *object)
 #endif
 
                 Py_DECREF(utcoffset);
-                Py_DECREF(ordinal);
 
-                return (UDate) (timestamp * 1000.0);
+                return (UDate) (seconds * 1000.0);
             }
 
             Py_XDECREF(utcoffset);
-            Py_XDECREF(ordinal);
         }
     }
 
@@ -601,6 +1293,10 @@ void registerType(PyTypeObject *type, classid id)
 
 int isInstance(PyObject *arg, classid id, PyTypeObject *type)
 {
+    // the common case, an instance of the declared type or a subtype of it
+    if (PyObject_TypeCheck(arg, type))
+        return 1;
+
     if (PyObject_TypeCheck(arg, &UObjectType_))
     {
 #if U_ICU_VERSION_HEX < 0x04060000
@@ -628,7 +1324,7 @@ int isInstance(PyObject *arg, classid id, PyTypeObject *type)
         Py_DECREF(bn);
         Py_DECREF(n);
 
-        return b ? b : PyObject_TypeCheck(arg, type);
+        return b;
     }
 
     return 0;
@@ -755,7 +1451,15 @@ static UnicodeString *toUnicodeStringArray(PyObject *arg, int *len)
         for (int i = 0; i < *len; i++) {
             PyObject *obj = PySequence_GetItem(arg, i);
 
-            if (PyObject_TypeCheck(obj, &UObjectType_))
+            if (obj == NULL)
+            {
+                delete[] array;
+                return NULL;
+            }
+
+            // only the first item was type checked, other wrapped ICU
+            // objects are rejected by PyObject_AsUnicodeString()
+            if (isUnicodeString(obj))
             {
                 array[i] = *(UnicodeString *) ((t_uobject *) obj)->object;
                 Py_DECREF(obj);
@@ -771,6 +1475,7 @@ static UnicodeString *toUnicodeStringArray(PyObject *arg, int *len)
 
                     return NULL;
                 }
+                Py_DECREF(obj);
             }
         }
 
@@ -891,6 +1596,192 @@ static UBool *toUBoolArray(PyObject *arg, int *len)
     return NULL;
 }
 
+/* The kinds of python objects accepted by the simplest format characters */
+
+#define ARG_BYTES     0x01
+#define ARG_UNICODE   0x02
+#define ARG_INT       0x04
+#define ARG_LONG      0x08
+#define ARG_FLOAT     0x10
+#define ARG_BOOL      0x20
+#define ARG_NONE      0x40
+#define ARG_OTHER     0x80
+#define ARG_ANY       0xff
+
+static inline int getArgKinds(PyObject *arg)
+{
+    if (PyUnicode_Check(arg))
+        return ARG_UNICODE;
+    if (PyBytes_Check(arg))
+        return ARG_BYTES;
+    if (PyFloat_Check(arg))
+        return ARG_FLOAT;
+    if (arg == Py_None)
+        return ARG_NONE;
+
+    int kinds = 0;
+
+    if (PyInt_Check(arg))
+        kinds |= ARG_INT;
+    if (PyLong_Check(arg))
+        kinds |= ARG_LONG;
+    if (arg == Py_True || arg == Py_False)
+        kinds |= ARG_BOOL;
+
+    return kinds ? kinds : ARG_OTHER;
+}
+
+/* An argument of one of the kinds is accepted without further checks, any
+ * other is rejected when exact or else checked by its format character.
+ */
+struct argKinds {
+    unsigned char kinds;
+    unsigned char exact;
+};
+
+/* A format string compiled on first use by getArgsDescriptor() */
+struct argsDescriptor {
+    const char *types;
+    int count;
+    argKinds args[1];
+};
+
+static void compileArg(char type, argKinds *arg)
+{
+    arg->exact = 1;
+
+    switch (type) {
+      case 'c':           /* string */
+      case 'k':           /* string and size */
+      case 'C':           /* string, not to be unpacked */
+        arg->kinds = ARG_BYTES;
+        break;
+
+      case 's':           /* string or unicode, to UnicodeString ref */
+      case 'u':           /* string or unicode, to new UnicodeString ptr */
+      case 'n':           /* string or unicode, to utf8 charsArg */
+      case 'f':           /* string or unicode filename, to charsArg */
+        arg->kinds = ARG_BYTES | ARG_UNICODE;
+        break;
+
+      case 'S':           /* string, unicode or UnicodeString */
+      case 'W':           /* string, unicode or UnicodeString, to save */
+        arg->kinds = ARG_BYTES | ARG_UNICODE;
+        arg->exact = 0;
+        break;
+
+      case 'K':           /* python object of any type */
+      case 'b':           /* boolean */
+        arg->kinds = ARG_ANY;
+        break;
+
+      case 'N':           /* None */
+        arg->kinds = ARG_NONE;
+        break;
+
+      case 'B':           /* boolean, strict */
+        arg->kinds = ARG_BOOL;
+        break;
+
+      case 'i':           /* int */
+        arg->kinds = ARG_INT;
+        break;
+
+      case 'd':           /* double */
+        arg->kinds = ARG_FLOAT | ARG_INT | ARG_LONG;
+        break;
+
+      case 'L':           /* PY_LONG_LONG */
+        arg->kinds = ARG_LONG | ARG_INT;
+        break;
+
+      default:
+        arg->kinds = 0;
+        arg->exact = 0;
+        break;
+    }
+}
+
+/* The compiled format strings, in an open addressing hash table keyed by
+ * address as parseArgs() is only passed string literals. The GIL protects
+ * the table.
+ */
+static argsDescriptor **descriptors = NULL;
+static size_t descriptorsMask = 0;
+static size_t descriptorsCount = 0;
+
+static inline size_t hashTypes(const char *types)
+{
+    return (size_t) (((uint64_t) (uintptr_t) types *
+                      0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+static void insertDescriptor(argsDescriptor **table, size_t mask,
+                             argsDescriptor *descriptor)
+{
+    size_t i = hashTypes(descriptor->types) & mask;
+
+    while (table[i] != NULL)
+        i = (i + 1) & mask;
+
+    table[i] = descriptor;
+}
+
+/* Returns the descriptor of types, NULL with an error set when out of
+ * memory. */
+static argsDescriptor *getArgsDescriptor(const char *types)
+{
+    if (descriptors != NULL)
+    {
+        for (size_t i = hashTypes(types) & descriptorsMask;
+             descriptors[i] != NULL; i = (i + 1) & descriptorsMask) {
+            if (descriptors[i]->types == types)
+                return descriptors[i];
+        }
+    }
+
+    if ((descriptorsCount + 1) * 2 > descriptorsMask + 1)
+    {
+        size_t mask = descriptors == NULL ? 255 : descriptorsMask * 2 + 1;
+        argsDescriptor **table = (argsDescriptor **)
+            calloc(mask + 1, sizeof(argsDescriptor *));
+
+        if (table == NULL)
+        {
+            PyErr_NoMemory();
+            return NULL;
+        }
+
+        for (size_t i = 0; descriptors != NULL && i <= descriptorsMask; i++)
+            if (descriptors[i] != NULL)
+                insertDescriptor(table, mask, descriptors[i]);
+
+        free(descriptors);
+        descriptors = table;
+        descriptorsMask = mask;
+    }
+
+    int count = (int) strlen(types);
+    argsDescriptor *descriptor = (argsDescriptor *)
+        malloc(sizeof(argsDescriptor) + count * sizeof(argKinds));
+
+    if (descriptor == NULL)
+    {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    descriptor->types = types;
+    descriptor->count = count;
+    for (int i = 0; i < count; i++)
+        compileArg(types[i], &descriptor->args[i]);
+
+    insertDescriptor(descriptors, descriptorsMask, descriptor);
+    descriptorsCount += 1;
+
+    return descriptor;
+}
+
 #if defined(_MSC_VER) || defined(PYPY_VERSION)
 
 int __parseArgs(PyObject *args, const char *types, ...)
@@ -937,16 +1828,19 @@ int _parseArgs(PyObject *args, int count, const char *types, va_list list)
 int _parseArgs(PyObject **args, int count, const char *types, va_list list)
 #endif
 {
-    if (count != strlen(types))
+    argsDescriptor *descriptor = getArgsDescriptor(types);
+
+    if (descriptor == NULL || count != descriptor->count)
         return -1;
 
 #else
 
 int _parseArgs(PyObject **args, int count, const char *types, ...)
 {
+    argsDescriptor *descriptor = getArgsDescriptor(types);
     va_list list;
 
-    if (count != (int) strlen(types))
+    if (descriptor == NULL || count != descriptor->count)
         return -1;
 
     va_start(list, types);
@@ -962,27 +1856,19 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
 #else
         PyObject *arg = args[i];
 #endif
+        const argKinds &kinds = descriptor->args[i];
 
-        switch (types[i]) {
-          case 'c':           /* string */
-          case 'k':           /* string and size */
-          case 'C':           /* string, not to be unpacked */
-            if (PyBytes_Check(arg))
-                break;
-            return -1;
+        if (kinds.kinds == ARG_ANY ||
+            (kinds.kinds != 0 && (kinds.kinds & getArgKinds(arg))))
+            continue;
 
-          case 's':           /* string or unicode, to UnicodeString ref */
-          case 'u':           /* string or unicode, to new UnicodeString ptr */
-          case 'n':           /* string or unicode, to utf8 charsArg */
-          case 'f':           /* string or unicode filename, to charsArg */
-            if (PyBytes_Check(arg) || PyUnicode_Check(arg))
-                break;
+        if (kinds.exact)
             return -1;
 
-          case 'S':           /* string, unicode or UnicodeString */
-          case 'W':           /* string, unicode or UnicodeString, to save */
-            if (PyBytes_Check(arg) || PyUnicode_Check(arg) ||
-                isUnicodeString(arg))
+        switch (types[i]) {
+          case 'S':           /* or UnicodeString */
+          case 'W':           /* or UnicodeString, to save */
+            if (isUnicodeString(arg))
                 break;
             return -1;
 
@@ -1009,9 +1895,6 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
                 break;
             return -1;
 
-          case 'K':           /* python object of any type */
-              break;
-
           case 'M':           /* python callable */
           {
               if (PyCallable_Check(arg))
@@ -1019,13 +1902,6 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
               return -1;
           }
 
-          case 'N':           /* None */
-          {
-              if (arg == Py_None)
-                  break;
-              return -1;
-          }
-
           case 'O':           /* python object of given type */
           {
               PyTypeObject *type = va_arg(list, PyTypeObject *);
@@ -1084,24 +1960,6 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
                 break;
             return -1;
 
-          case 'B':           /* boolean, strict */
-            if (arg == Py_True || arg == Py_False)
-                break;
-            return -1;
-
-          case 'b':           /* boolean */
-            break;
-
-          case 'i':           /* int */
-            if (PyInt_Check(arg))
-                break;
-            return -1;
-
-          case 'd':           /* double */
-            if (PyFloat_Check(arg) || PyInt_Check(arg) || PyLong_Check(arg))
-                break;
-            return -1;
-
           case 'F':           /* array of double */
             if (PySequence_Check(arg))
             {
@@ -1142,11 +2000,6 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
             }
             return -1;
 
-          case 'L':           /* PY_LONG_LONG */
-            if (PyLong_Check(arg) || PyInt_Check(arg))
-                break;
-            return -1;
-
           default:
             return -1;
         }
@@ -1270,7 +2123,7 @@ int _parseArgs(PyObject **args, int count, const char *types, ...)
               else
               {
                   try {
-                      PyObject_AsUnicodeString(arg, *_u);
+                      PyObject_AsUnicodeStringAlias(arg, *_u);
                       *u = _u;
                   } catch (ICUException e) {
                       e.reportError();
@@ -1531,6 +2384,265 @@ UnicodeString fromUChar32(UChar32 c)
 }
 
 
+/* ObjectLock, called with the GIL held */
+
+void ObjectLock::acquire()
+{
+    long ident = (long) PyThread_get_thread_ident();
+
+    if (count > 0 && owner == ident)
+    {
+        count += 1;
+        return;
+    }
+
+    if (lock == NULL)
+    {
+        lock = PyThread_allocate_lock();
+        if (lock == NULL)
+            return;  // out of memory, proceed unlocked
+    }
+
+    if (!PyThread_acquire_lock(lock, NOWAIT_LOCK))
+    {
+        // don't hold the GIL while the owner may need it to finish
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock(lock, WAIT_LOCK);
+        Py_END_ALLOW_THREADS
+    }
+
+    owner = ident;
+    count = 1;
+}
+
+void ObjectLock::release()
+{
+    if (lock != NULL && count > 0 && --count == 0)
+    {
+        owner = 0;
+        PyThread_release_lock(lock);
+    }
+}
+
+void ObjectLock::free()
+{
+    if (lock != NULL)
+    {
+        PyThread_free_lock(lock);
+        lock = NULL;
+    }
+}
+
+bool SharedLock::acquireShared()
+{
+    if (waiting > 0)
+        return false;
+
+    if (readers == 0)
+    {
+        if (idle == NULL)
+        {
+            idle = PyThread_allocate_lock();
+            if (idle == NULL)
+                return false;  // out of memory, keep the GIL
+        }
+
+        // not held by a setter, it only waits on it while waiting > 0
+        PyThread_acquire_lock(idle, NOWAIT_LOCK);
+    }
+    readers += 1;
+
+    return true;
+}
+
+void SharedLock::releaseShared()
+{
+    if (--readers == 0)
+        PyThread_release_lock(idle);
+}
+
+void SharedLock::acquireExclusive()
+{
+    if (readers == 0)
+        return;
+
+    waiting += 1;
+    while (readers > 0) {
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock(idle, WAIT_LOCK);
+        PyThread_release_lock(idle);
+        Py_END_ALLOW_THREADS
+    }
+    waiting -= 1;
+}
+
+void SharedLock::free()
+{
+    if (idle != NULL)
+    {
+        PyThread_free_lock(idle);
+        idle = NULL;
+    }
+}
+
+
+LRUCache::LRUCache(Py_ssize_t capacity)
+{
+    entries = NULL;
+    first = last = NULL;
+    size = 0;
+    this->capacity = capacity;
+    hits = misses = evictions = 0;
+}
+
+void LRUCache::unlink(entry *e)
+{
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        first = e->next;
+
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        last = e->prev;
+}
+
+void LRUCache::link(entry *e)
+{
+    e->prev = NULL;
+    e->next = first;
+
+    if (first)
+        first->prev = e;
+    else
+        last = e;
+
+    first = e;
+}
+
+void LRUCache::evict(Py_ssize_t capacity)
+{
+    while (size > capacity) {
+        entry *e = last;
+
+        unlink(e);
+        size -= 1;
+
+        PyDict_DelItem(entries, e->key);
+        Py_DECREF(e->key);
+        Py_DECREF(e->value);
+        delete e;
+
+        evictions += 1;
+    }
+}
+
+PyObject *LRUCache::lookup(PyObject *key)
+{
+    PyObject *address = entries ? PyDict_GetItem(entries, key) : NULL;
+
+    if (address == NULL)
+    {
+        misses += 1;
+        return NULL;
+    }
+
+    entry *e = (entry *) PyLong_AsVoidPtr(address);
+
+    hits += 1;
+
+    if (e != first)
+    {
+        unlink(e);
+        link(e);
+    }
+
+    Py_INCREF(e->value);
+    return e->value;
+}
+
+int LRUCache::insert(PyObject *key, PyObject *value)
+{
+    if (capacity == 0)
+        return 0;
+
+    if (entries == NULL)
+    {
+        entries = PyDict_New();
+        if (entries == NULL)
+            return -1;
+    }
+
+    PyObject *address = PyDict_GetItem(entries, key);
+
+    if (address != NULL)
+    {
+        // already cached, the entry's value is replaced and it's moved first
+        entry *e = (entry *) PyLong_AsVoidPtr(address);
+        PyObject *previous = e->value;
+
+        Py_INCREF(value);
+        e->value = value;
+
+        if (e != first)
+        {
+            unlink(e);
+            link(e);
+        }
+        Py_DECREF(previous);
+
+        return 0;
+    }
+
+    entry *e = new entry();
+
+    address = PyLong_FromVoidPtr(e);
+
+    if (address == NULL || PyDict_SetItem(entries, key, address) < 0)
+    {
+        Py_XDECREF(address);
+        delete e;
+
+        return -1;
+    }
+    Py_DECREF(address);
+
+    e->key = key;
+    e->value = value;
+    Py_INCREF(key);
+    Py_INCREF(value);
+
+    link(e);
+    size += 1;
+    evict(capacity);
+
+    return 0;
+}
+
+PyObject *LRUCache::getInfo()
+{
+    return Py_BuildValue("{sLsLsLsnsn}",
+                         "hits", hits,
+                         "misses", misses,
+                         "evictions", evictions,
+                         "size", size,
+                         "capacity", capacity);
+}
+
+void LRUCache::setCapacity(Py_ssize_t capacity)
+{
+    evict(capacity);
+    this->capacity = capacity;
+}
+
+void LRUCache::clear()
+{
+    evict(0);
+    hits = misses = evictions = 0;
+}
+
+
 void _init_common(PyObject *m)
 {
     types = PyDict_New();
@@ -1541,6 +2653,4 @@ void _init_common(PyObject *m)
 #endif
 
     utcoffset_NAME = PyString_FromString("utcoffset");
-    toordinal_NAME = PyString_FromString("toordinal");
-    getDefault_NAME = PyString_FromString("getDefault");
 }
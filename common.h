@@ -355,6 +355,25 @@ EXPORT UnicodeString &PyObject_AsUnicodeString(PyObject *object,
 EXPORT UnicodeString &PyObject_AsUnicodeString(PyObject *object,
                                                UnicodeString &string);
 EXPORT UnicodeString *PyObject_AsUnicodeString(PyObject *object);
+EXPORT UnicodeString &PyObject_AsUnicodeStringAlias(PyObject *object,
+                                                    UnicodeString &string);
+
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+/* Opens ut, or a new UText when NULL, over a python str without copying
+ * it. Native indexes are python str indexes, code point indexes. The str
+ * is not referenced and must outlive ut and its clones.
+ */
+UText *openPythonText(UText *ut, PyObject *object, UErrorCode &status);
+bool isPythonText(const UText *ut);
+
+/* Whether object is a str whose code point indexes are also its UTF-16
+ * indexes, that can be read in place where UTF-16 offsets are returned */
+inline bool isBMPText(PyObject *object)
+{
+    return (PyUnicode_Check(object) && PyUnicode_READY(object) == 0 &&
+            PyUnicode_KIND(object) != PyUnicode_4BYTE_KIND);
+}
+#endif
 EXPORT UDate PyObject_AsUDate(PyObject *object);
 
 int abstract_init(PyObject *self, PyObject *args, PyObject *kwds);
@@ -420,6 +439,10 @@ public:
     }
 };
 
+/* The types format string must be a string literal, it is compiled once
+ * and looked up by address on later calls.
+ */
+
 #if defined(_MSC_VER) || defined(PYPY_VERSION)
 
 #define parseArgs __parseArgs
@@ -443,7 +466,7 @@ int _parseArgs(PyObject **args, int count, const char *types, va_list list);
 
 #define parseArgs(args, types, rest...) \
     _parseArgs(((PyTupleObject *)(args))->ob_item, \
-               (int) PyObject_Size(args), types, ##rest)
+               (int) PyTuple_GET_SIZE(args), types, ##rest)
 
 #define parseArg(arg, types, rest...) \
     _parseArgs(&(arg), 1, types, ##rest)
@@ -452,6 +475,152 @@ int _parseArgs(PyObject **args, int count, const char *types, ...);
 
 #endif
 
+/* Releasing the GIL costs a thread switch when other threads are waiting
+ * for it, it is only worth it for calls processing enough text. Strings
+ * borrowed from wrapped UnicodeString objects are never processed with the
+ * GIL released since another thread could modify them meanwhile.
+ */
+#define ALLOW_THREADS_MIN_LENGTH 1024
+
+inline int allowThreads(int32_t length)
+{
+    return length >= ALLOW_THREADS_MIN_LENGTH;
+}
+
+inline int allowThreads(const UnicodeString *u, const UnicodeString *_u)
+{
+    return u == _u && allowThreads(u->length());
+}
+
+inline int allowThreads(const UnicodeString *u0, const UnicodeString *_u0,
+                        const UnicodeString *u1, const UnicodeString *_u1)
+{
+    return (u0 == _u0 && u1 == _u1 &&
+            allowThreads(u0->length() + u1->length()));
+}
+
+/* A recursive lock for wrapped ICU objects that are not thread-safe but are
+ * used with the GIL released, such as RegexMatcher. It is embedded in the
+ * python wrapper and zero-initialized by tp_alloc, the actual lock is
+ * allocated when first acquired and must be freed by the wrapper's dealloc.
+ */
+class ObjectLock {
+public:
+    PyThread_type_lock lock;
+    long owner;
+    int count;
+
+    void acquire();
+    void release();
+    void free();
+};
+
+// helper class, to hold an ObjectLock for the duration of a scope
+class ObjectLocker {
+private:
+    ObjectLock &lock;
+
+public:
+    explicit ObjectLocker(ObjectLock &lock) : lock(lock)
+    {
+        lock.acquire();
+    }
+
+    ~ObjectLocker()
+    {
+        lock.release();
+    }
+};
+
+/* A lock for wrapped ICU objects that are only read with the GIL released
+ * and only modified, by setters, with the GIL held, such as Collator.
+ * Readers don't block each other, a reader starting while a setter waits
+ * keeps the GIL instead. It is zero-initialized by tp_alloc like ObjectLock
+ * and must be freed by the wrapper's dealloc.
+ */
+class SharedLock {
+public:
+    PyThread_type_lock idle;  // held while readers > 0
+    int readers;
+    int waiting;
+
+    // with the GIL held, returns whether the GIL may then be released
+    bool acquireShared();
+    void releaseShared();
+    // returns with the GIL held once no reader is left, the caller must
+    // not release the GIL before it's done modifying the object
+    void acquireExclusive();
+    void free();
+};
+
+// helper class, to read an object under a SharedLock for a scope
+class SharedLocker {
+private:
+    SharedLock &lock;
+
+public:
+    const bool shared;  // the GIL may be released
+
+    explicit SharedLocker(SharedLock &lock) :
+        lock(lock), shared(lock.acquireShared()) {}
+
+    ~SharedLocker()
+    {
+        if (shared)
+            lock.releaseShared();
+    }
+};
+
+/* A bounded, least recently used first, cache of python objects by key,
+ * only accessed with the GIL held */
+class LRUCache {
+private:
+    struct entry {
+        PyObject *key;
+        PyObject *value;
+        entry *prev, *next;
+    };
+
+    PyObject *entries;  // key -> entry address
+    entry *first;       // most recently used
+    entry *last;        // least recently used
+    Py_ssize_t size, capacity;
+    PY_LONG_LONG hits, misses, evictions;
+
+    void unlink(entry *e);
+    void link(entry *e);
+    void evict(Py_ssize_t capacity);
+
+public:
+    explicit LRUCache(Py_ssize_t capacity);
+
+    // returns a new reference to the cached value or NULL, without error
+    PyObject *lookup(PyObject *key);
+    // replaces the value of a key already cached
+    int insert(PyObject *key, PyObject *value);
+
+    // the python methods: getCacheInfo(), setCacheSize() and clearCache()
+    PyObject *getInfo();
+    void setCapacity(Py_ssize_t capacity);
+    void clear();
+};
+
+/* Days since 1970-01-01 of a proleptic gregorian date, month is 1-based */
+int64_t daysFromCivil(int year, int month, int day);
+
+/* Whether a buffer's items are of the given struct module type code, in
+ * native byte order and size */
+bool isNativeFormat(const Py_buffer *view, char code, int size);
+
+/* A memoryview of native int32 over bytes, a bytearray whose reference is
+ * stolen */
+PyObject *toInt32View(PyObject *bytes);
+
+/* A list of str or, when packed, a pair of bytes holding the UTF-8 encoded
+ * strings back to back and count + 1 native int64 offsets into them */
+PyObject *fromUnicodeStrings(const UnicodeString *strings,
+                             Py_ssize_t count, int packed);
+
 int isUnicodeString(PyObject *arg);
 int32_t toUChar32(UnicodeString& u, UChar32 *c, UErrorCode& status);
 UnicodeString fromUChar32(UChar32 c);
@@ -23,6 +23,7 @@
 
 #include "common.h"
 #include "structmember.h"
+#include <math.h>
 
 #include "bases.h"
 #include "locale.h"
@@ -128,6 +129,7 @@ public:
 static PyObject *t_dateformat_isLenient(t_dateformat *self);
 static PyObject *t_dateformat_setLenient(t_dateformat *self, PyObject *arg);
 static PyObject *t_dateformat_format(t_dateformat *self, PyObject *args);
+static PyObject *t_dateformat_formatMany(t_dateformat *self, PyObject *args);
 static PyObject *t_dateformat_parse(t_dateformat *self, PyObject *args);
 static PyObject *t_dateformat_getCalendar(t_dateformat *self);
 static PyObject *t_dateformat_setCalendar(t_dateformat *self, PyObject *arg);
@@ -156,6 +158,7 @@ static PyMethodDef t_dateformat_methods[] = {
     DECLARE_METHOD(t_dateformat, isLenient, METH_NOARGS),
     DECLARE_METHOD(t_dateformat, setLenient, METH_O),
     DECLARE_METHOD(t_dateformat, format, METH_VARARGS),
+    DECLARE_METHOD(t_dateformat, formatMany, METH_VARARGS),
     DECLARE_METHOD(t_dateformat, parse, METH_VARARGS),
     DECLARE_METHOD(t_dateformat, getCalendar, METH_NOARGS),
     DECLARE_METHOD(t_dateformat, setCalendar, METH_O),
@@ -891,6 +894,377 @@ static PyObject *t_dateformat_format(t_dateformat *self, PyObject *args)
     return t_format_format((t_format *) self, args);
 }
 
+/* Bulk formatting memoizes what it can of a SimpleDateFormat pattern. The
+ * fields that only change with the local day are formatted once per day
+ * with a day pattern, where every time field is replaced by a marker. Hour,
+ * minute, second, fraction and am/pm fields are formatted once per value.
+ * Other time fields, such as time zones, are formatted with a time pattern
+ * made of all time fields separated by markers.
+ */
+
+#define DAY_FIELD_LETTERS "GyYuUrQqMLlwWdDFgEec"
+#define MEMO_FIELD_LETTERS "HkKhamsS"
+#define FIELD_MARKER ((UChar) 0xffff)
+#define MIN_MEMO_COUNT 64
+#define MAX_MEMO_DATE 1e15
+
+struct TimeField {
+    UChar letter;
+    int32_t divisor;             // of the milliseconds, for fractions
+    SimpleDateFormat *format;
+    UnicodeString *texts;        // by value, bogus until formatted
+};
+
+class DateMemoizer {
+public:
+    SimpleDateFormat *dayFormat;
+    SimpleDateFormat *timeFormat;    // unless all time fields are memoized
+    TimeField *fields;
+    int fieldCount;
+    int32_t *dayPieces;              // start of each piece of dayText
+    double day;
+    UnicodeString dayText, timeText;
+
+    DateMemoizer() : dayFormat(NULL), timeFormat(NULL), fields(NULL),
+                     fieldCount(0), dayPieces(NULL), day(0.0)
+    {
+        dayText.setToBogus();
+    }
+
+    ~DateMemoizer();
+
+    bool init(const SimpleDateFormat *format, UErrorCode &status);
+    bool format(const TimeZone &tz, UDate date, UnicodeString &result,
+                UErrorCode &status);
+};
+
+DateMemoizer::~DateMemoizer()
+{
+    for (int i = 0; fields != NULL && i < fieldCount; ++i) {
+        delete fields[i].format;
+        delete[] fields[i].texts;
+    }
+
+    delete dayFormat;
+    delete timeFormat;
+    delete[] fields;
+    delete[] dayPieces;
+}
+
+static int32_t fieldValue(const TimeField &field, int32_t millis)
+{
+    switch (field.letter) {
+      case 'm':
+        return millis / 60000 % 60;
+      case 's':
+        return millis / 1000 % 60;
+      case 'S':
+        return millis % 1000 / field.divisor;
+      default:  // all other memoized fields only depend on the hour
+        return millis / 3600000;
+    }
+}
+
+bool DateMemoizer::init(const SimpleDateFormat *format, UErrorCode &status)
+{
+#if U_ICU_VERSION_HEX >= VERSION_HEX(53, 0, 0)
+    // capitalization depends on where a field ends up
+    if (format->getContext(UDISPCTX_TYPE_CAPITALIZATION, status) !=
+        UDISPCTX_CAPITALIZATION_NONE || U_FAILURE(status))
+        return false;
+#endif
+
+    UnicodeString pattern, dayPattern, timePattern;
+    bool memoized = true;
+    int32_t len;
+
+    format->toPattern(pattern);
+    len = pattern.length();
+    fields = new TimeField[len + 1];
+
+    for (int32_t i = 0; i < len;) {
+        UChar c = pattern.charAt(i);
+        int32_t start = i;
+
+        if (c == '\'')
+        {
+            // a quoted literal, with '' for a quote, or just ''
+            for (++i; i < len; ++i) {
+                if (pattern.charAt(i) == '\'')
+                {
+                    if (i + 1 < len && pattern.charAt(i + 1) == '\'')
+                        ++i;
+                    else
+                        break;
+                }
+            }
+            i = i < len ? i + 1 : len;
+            dayPattern.append(pattern, start, i - start);
+        }
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        {
+            while (i < len && pattern.charAt(i) == c)
+                ++i;
+
+            if (strchr(DAY_FIELD_LETTERS, (char) c))
+                dayPattern.append(pattern, start, i - start);
+            else
+            {
+                TimeField &field = fields[fieldCount++];
+                int32_t count = i - start;
+
+                field.letter = c;
+                field.divisor = c == 'S' && count < 3
+                    ? (count == 1 ? 100 : 10) : 1;
+                field.format = NULL;
+                field.texts = NULL;
+
+                if (!strchr(MEMO_FIELD_LETTERS, (char) c) ||
+                    (c == 'S' && count > 3))
+                    memoized = false;
+
+                if (fieldCount > 1)
+                    timePattern.append(FIELD_MARKER);
+                timePattern.append(pattern, start, count);
+                dayPattern.append(FIELD_MARKER);
+            }
+        }
+        else if (c == FIELD_MARKER)
+            return false;
+        else
+        {
+            dayPattern.append(c);
+            ++i;
+        }
+    }
+
+    dayFormat = (SimpleDateFormat *) format->clone();
+    dayFormat->applyPattern(dayPattern);
+    dayPieces = new int32_t[fieldCount + 2];
+
+    if (memoized && fieldCount > 0)
+    {
+        int32_t field = 0;
+
+        // the time fields are in the same order in timePattern
+        for (int32_t i = 0; i <= timePattern.length(); ++i) {
+            if (i < timePattern.length() &&
+                timePattern.charAt(i) != FIELD_MARKER)
+                continue;
+
+            TimeField &timeField = fields[field++];
+            int32_t start = i - 1;
+
+            while (start >= 0 && timePattern.charAt(start) != FIELD_MARKER)
+                --start;
+
+            timeField.format = (SimpleDateFormat *) format->clone();
+            timeField.format->applyPattern(
+                UnicodeString(timePattern, start + 1, i - start - 1));
+
+            int32_t size = timeField.letter == 'S'
+                ? 1000 / timeField.divisor
+                : (timeField.letter == 'm' || timeField.letter == 's'
+                   ? 60 : 24);
+
+            timeField.texts = new UnicodeString[size];
+            for (int32_t j = 0; j < size; ++j)
+                timeField.texts[j].setToBogus();
+        }
+    }
+    else if (!memoized)
+    {
+        timeFormat = (SimpleDateFormat *) format->clone();
+        timeFormat->applyPattern(timePattern);
+    }
+
+    return true;
+}
+
+// returns false when the date should be formatted without memoization
+bool DateMemoizer::format(const TimeZone &tz, UDate date,
+                          UnicodeString &result, UErrorCode &status)
+{
+    if (!(date > -MAX_MEMO_DATE && date < MAX_MEMO_DATE))
+        return false;
+
+    int32_t rawOffset, dstOffset;
+
+    tz.getOffset(date, false, rawOffset, dstOffset, status);
+    if (U_FAILURE(status))
+        return false;
+
+    double local = date + rawOffset + dstOffset;
+    double localDay = floor(local / U_MILLIS_PER_DAY);
+    double millis = local - localDay * U_MILLIS_PER_DAY;
+
+    if (!(millis >= 0.0 && millis < U_MILLIS_PER_DAY))
+        return false;
+
+    if (localDay != day || dayText.isBogus())
+    {
+        int count = 0;
+
+        dayText.remove();
+        dayFormat->format(date, dayText);
+
+        dayPieces[count++] = 0;
+        for (int32_t i = 0; i < dayText.length(); ++i) {
+            if (dayText.charAt(i) == FIELD_MARKER)
+            {
+                if (count > fieldCount)
+                    break;
+                dayPieces[count++] = i + 1;
+            }
+        }
+
+        // the marker could, unexpectedly, be part of a name
+        if (count != fieldCount + 1 ||
+            dayText.indexOf(FIELD_MARKER,
+                            count > 1 ? dayPieces[count - 1] : 0) >= 0)
+        {
+            dayText.setToBogus();
+            return false;
+        }
+
+        dayPieces[count] = dayText.length() + 1;
+        day = localDay;
+    }
+
+    if (timeFormat != NULL)
+    {
+        timeText.remove();
+        timeFormat->format(date, timeText);
+    }
+
+    int32_t timeStart = 0;
+
+    result.remove();
+    for (int i = 0; i <= fieldCount; ++i) {
+        result.append(dayText, dayPieces[i],
+                      dayPieces[i + 1] - dayPieces[i] - 1);
+
+        if (i == fieldCount)
+            break;
+
+        if (timeFormat == NULL)
+        {
+            TimeField &field = fields[i];
+            UnicodeString &text = field.texts[
+                fieldValue(field, (int32_t) millis)];
+
+            if (text.isBogus())
+            {
+                UnicodeString formatted;
+
+                field.format->format(date, formatted);
+                text = formatted;
+            }
+
+            result.append(text);
+        }
+        else
+        {
+            int32_t timeEnd = timeText.indexOf(FIELD_MARKER, timeStart);
+
+            // only the last time piece isn't followed by a marker
+            if ((timeEnd < 0) != (i == fieldCount - 1))
+                return false;
+            if (timeEnd < 0)
+                timeEnd = timeText.length();
+
+            result.append(timeText, timeStart, timeEnd - timeStart);
+            timeStart = timeEnd + 1;
+        }
+    }
+
+    return true;
+}
+
+static void formatDates(DateFormat *format, const UDate *dates,
+                        Py_ssize_t count, UnicodeString *strings,
+                        UErrorCode &status)
+{
+    SimpleDateFormat *sdf = dynamic_cast<SimpleDateFormat *>(format);
+    DateMemoizer memoizer;
+    bool memoize = (sdf != NULL && count >= MIN_MEMO_COUNT &&
+                    memoizer.init(sdf, status));
+
+    if (U_FAILURE(status))
+        return;
+
+    const TimeZone &tz = format->getTimeZone();
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (!(memoize && memoizer.format(tz, dates[i], strings[i], status)))
+        {
+            if (U_FAILURE(status))
+                return;
+
+            strings[i].remove();
+            format->format(dates[i], strings[i]);
+        }
+    }
+}
+
+static PyObject *t_dateformat_formatMany(t_dateformat *self, PyObject *args)
+{
+    PyObject *dates, *result;
+    Py_buffer view;
+    int packed = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 2:
+        packed = PyObject_IsTrue(PyTuple_GET_ITEM(args, 1));
+        if (packed < 0)
+            return NULL;
+        /* fall through */
+      case 1:
+        dates = PyTuple_GET_ITEM(args, 0);
+        break;
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+    }
+
+    if (PyObject_GetBuffer(dates, &view,
+                           PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+    {
+        PyErr_Clear();
+        return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+    }
+
+    if (!isNativeFormat(&view, 'd', sizeof(UDate)))
+    {
+        PyBuffer_Release(&view);
+        return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+    }
+
+    // formatting changes the format's calendar, a copy is used instead
+    DateFormat *format = (DateFormat *) self->object->clone();
+    Py_ssize_t count = view.len / sizeof(UDate);
+    UnicodeString *strings = new UnicodeString[count + 1];
+    UErrorCode status = U_ZERO_ERROR;
+
+    ALLOW_THREADS_CALL(
+        count >= ALLOW_THREADS_MIN_LENGTH,
+        formatDates(format, (const UDate *) view.buf, count, strings,
+                    status));
+
+    PyBuffer_Release(&view);
+    delete format;
+
+    if (U_FAILURE(status))
+    {
+        delete[] strings;
+        return ICUException(status).reportError();
+    }
+
+    result = fromUnicodeStrings(strings, count, packed);
+    delete[] strings;
+
+    return result;
+}
+
 static PyObject *t_dateformat_parse(t_dateformat *self, PyObject *args)
 {
     UnicodeString *u;
@@ -29,6 +29,9 @@
 #include "iterators.h"
 #include "macros.h"
 
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+DECLARE_CONSTANTS_TYPE(UWordBreak)
+#endif
 
 /* ForwardCharacterIterator */
 
@@ -218,6 +221,11 @@ static PyObject *t_breakiterator_getDisplayName(PyTypeObject *type,
 #if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
 static PyObject *t_breakiterator_getRuleStatus(t_breakiterator *self);
 #endif
+static PyObject *t_breakiterator_boundaries(t_breakiterator *self,
+                                            PyObject *args);
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+static PyObject *t_breakiterator_tokenize(PyTypeObject *type, PyObject *args);
+#endif
 
 static PyMethodDef t_breakiterator_methods[] = {
     DECLARE_METHOD(t_breakiterator, getText, METH_NOARGS),
@@ -241,6 +249,10 @@ static PyMethodDef t_breakiterator_methods[] = {
     DECLARE_METHOD(t_breakiterator, getDisplayName, METH_VARARGS | METH_CLASS),
 #if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
     DECLARE_METHOD(t_breakiterator, getRuleStatus, METH_NOARGS),
+#endif
+    DECLARE_METHOD(t_breakiterator, boundaries, METH_VARARGS),
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+    DECLARE_METHOD(t_breakiterator, tokenize, METH_VARARGS | METH_CLASS),
 #endif
     { NULL, NULL, 0, NULL }
 };
@@ -704,7 +716,19 @@ static PyObject *t_stringcharacteriterator_setText(t_stringcharacteriterator *se
 
 static PyObject *t_breakiterator_getText(t_breakiterator *self)
 {
-    CharacterIterator *iterator = self->object->getText().clone();
+    CharacterIterator *iterator;
+
+    // a str set with setText() is read in place, not through an iterator
+    if (self->text != NULL && PyUnicode_Check(self->text))
+    {
+        UnicodeString u;
+
+        PyObject_AsUnicodeString(self->text, u);
+        iterator = new StringCharacterIterator(u);
+    }
+    else
+        iterator = self->object->getText().clone();
+
     return wrap_CharacterIterator(iterator, T_OWNED);
 }
 
@@ -712,6 +736,29 @@ static PyObject *t_breakiterator_setText(t_breakiterator *self, PyObject *arg)
 {
     UnicodeString *u;
 
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+    // Latin-1 and UCS-2 strs are read in place, their code point indexes
+    // being their UTF-16 indexes
+    if (isBMPText(arg))
+    {
+        UText ut = UTEXT_INITIALIZER;
+        UErrorCode status = U_ZERO_ERROR;
+
+        openPythonText(&ut, arg, status);
+        self->object->setText(&ut, status);  /* cloned, str not ref'd */
+        utext_close(&ut);
+
+        if (U_FAILURE(status))
+            return ICUException(status).reportError();
+
+        Py_INCREF(arg);
+        Py_XDECREF(self->text);
+        self->text = arg;
+
+        Py_RETURN_NONE;
+    }
+#endif
+
     if (!parseArg(arg, "W", &u, &self->text))
     {
         self->object->setText(*u); /* ref'd */
@@ -1013,6 +1060,464 @@ static PyObject *t_breakiterator_iter_next(t_breakiterator *self)
     return PyInt_FromLong(n);
 }
 
+/* Collects the boundaries of iterator, from first() on, into offsets and,
+ * when not NULL, their rule statuses into statuses. Both must have room for
+ * length + 1 values. When text is not NULL, the UTF-16 offsets are converted
+ * to code point offsets into it. Returns the number of boundaries.
+ */
+static int32_t getBoundaries(BreakIterator *iterator, const UnicodeString *text,
+                             int32_t *offsets, int32_t *statuses)
+{
+    int32_t count = 0;
+
+    for (int32_t n = iterator->first(); n != BreakIterator::DONE;
+         n = iterator->next())
+    {
+        offsets[count] = n;
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+        if (statuses != NULL)
+            statuses[count] = iterator->getRuleStatus();
+#endif
+        count += 1;
+    }
+
+    if (text != NULL)
+    {
+        const UChar *chars = text->getBuffer();
+        int32_t length = text->length();
+        int32_t prev = 0, cp = 0;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            int32_t offset = offsets[i];
+
+            if (offset > length)
+                offset = length;
+            if (offset > prev)
+            {
+                cp += u_countChar32(chars + prev, offset - prev);
+                prev = offset;
+            }
+            offsets[i] = cp;
+        }
+    }
+
+    return count;
+}
+
+static PyObject *t_breakiterator_boundaries(t_breakiterator *self,
+                                            PyObject *args)
+{
+    int statuses = 0, codePoints = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 0:
+        break;
+      case 1:
+        if (!parseArgs(args, "b", &statuses))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "boundaries", args);
+      case 2:
+        if (!parseArgs(args, "bb", &statuses, &codePoints))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "boundaries", args);
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "boundaries", args);
+    }
+
+#if U_ICU_VERSION_HEX < VERSION_HEX(52, 0, 0)
+    if (statuses)
+    {
+        PyErr_SetString(PyExc_NotImplementedError, "rule statuses");
+        return NULL;
+    }
+#endif
+
+    UErrorCode status = U_ZERO_ERROR;
+    UText *ut = self->object->getUText(NULL, status);
+
+    if (U_FAILURE(status))
+        return ICUException(status).reportError();
+
+    int64_t length = utext_nativeLength(ut);
+    utext_close(ut);
+
+    if (length >= INT32_MAX / (Py_ssize_t) sizeof(int32_t))
+        return PyErr_NoMemory();
+
+    const UnicodeString *text = NULL;
+    // a str read in place is indexed by code point already
+    if (codePoints && self->text != NULL && !PyUnicode_Check(self->text))
+        text = (UnicodeString *) ((t_uobject *) self->text)->object;
+
+    PyObject *offsets = PyByteArray_FromStringAndSize(
+        NULL, (length + 1) * sizeof(int32_t));
+    PyObject *ruleStatuses = NULL;
+
+    if (offsets == NULL)
+        return NULL;
+
+    if (statuses)
+    {
+        ruleStatuses = PyByteArray_FromStringAndSize(
+            NULL, (length + 1) * sizeof(int32_t));
+        if (ruleStatuses == NULL)
+        {
+            Py_DECREF(offsets);
+            return NULL;
+        }
+    }
+
+    int32_t *offsetBuf = (int32_t *) PyByteArray_AS_STRING(offsets);
+    int32_t *statusBuf = statuses
+        ? (int32_t *) PyByteArray_AS_STRING(ruleStatuses) : NULL;
+    int32_t count;
+
+    // a text set from a UnicodeString object may be modified by other
+    // threads, only a str or one copied from a str is safe to read
+    if (allowThreads((int32_t) length) &&
+        (self->text == NULL || PyUnicode_Check(self->text) ||
+         Py_REFCNT(self->text) == 1))
+    {
+        // self may be used by other threads while the GIL is released, so
+        // iterate a clone and keep the text alive
+        BreakIterator *iterator = self->object->clone();
+        PyObject *textRef = self->text;
+
+        if (iterator == NULL)
+        {
+            Py_DECREF(offsets);
+            Py_XDECREF(ruleStatuses);
+            return PyErr_NoMemory();
+        }
+
+        Py_XINCREF(textRef);
+        Py_BEGIN_ALLOW_THREADS
+        count = getBoundaries(iterator, text, offsetBuf, statusBuf);
+        delete iterator;
+        Py_END_ALLOW_THREADS
+        Py_XDECREF(textRef);
+    }
+    else
+    {
+        int32_t current = self->object->current();
+
+        count = getBoundaries(self->object, text, offsetBuf, statusBuf);
+        self->object->isBoundary(current);
+    }
+
+    if (PyByteArray_Resize(offsets, count * sizeof(int32_t)) < 0 ||
+        (ruleStatuses != NULL &&
+         PyByteArray_Resize(ruleStatuses, count * sizeof(int32_t)) < 0))
+    {
+        Py_DECREF(offsets);
+        Py_XDECREF(ruleStatuses);
+        return NULL;
+    }
+
+    offsets = toInt32View(offsets);
+    if (ruleStatuses == NULL || offsets == NULL)
+    {
+        Py_XDECREF(ruleStatuses);
+        return offsets;
+    }
+
+    ruleStatuses = toInt32View(ruleStatuses);
+    if (ruleStatuses == NULL)
+    {
+        Py_DECREF(offsets);
+        return NULL;
+    }
+
+    return Py_BuildValue("(NN)", offsets, ruleStatuses);
+}
+
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+
+/* Word iterators used by tokenize(), by locale name. A cached iterator is
+ * a prototype that is never iterated, tokenize() walks one of its clones.
+ */
+static LRUCache wordIteratorCache(16);
+static const UnicodeString emptyText;
+
+/* Clones of cached word iterators not in use, each with a reference to the
+ * cached iterator it was cloned from so that they can't be mistaken for
+ * another's. Only accessed with the GIL held.
+ */
+#define IDLE_WORD_ITERATORS 8
+
+static struct {
+    PyObject *prototype;
+    BreakIterator *iterator;
+} idleWordIterators[IDLE_WORD_ITERATORS];
+static int nextIdleWordIterator = 0;
+
+static BreakIterator *takeWordIterator(PyObject *prototype)
+{
+    for (int i = 0; i < IDLE_WORD_ITERATORS; ++i) {
+        if (idleWordIterators[i].prototype == prototype)
+        {
+            BreakIterator *iterator = idleWordIterators[i].iterator;
+
+            idleWordIterators[i].iterator = NULL;
+            Py_CLEAR(idleWordIterators[i].prototype);
+
+            return iterator;
+        }
+    }
+
+    return ((t_breakiterator *) prototype)->object->clone();
+}
+
+static void returnWordIterator(PyObject *prototype, BreakIterator *iterator)
+{
+    int slot = -1;
+
+    for (int i = 0; i < IDLE_WORD_ITERATORS; ++i) {
+        if (idleWordIterators[i].iterator == NULL)
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0)
+    {
+        slot = nextIdleWordIterator;
+        nextIdleWordIterator = (nextIdleWordIterator + 1) % IDLE_WORD_ITERATORS;
+
+        delete idleWordIterators[slot].iterator;
+        Py_CLEAR(idleWordIterators[slot].prototype);
+    }
+
+    Py_INCREF(prototype);
+    idleWordIterators[slot].prototype = prototype;
+    idleWordIterators[slot].iterator = iterator;
+}
+
+/* The bit of a word rule status in a tokenize() category mask, one bit for
+ * each UWordBreak range of 100 statuses */
+static inline uint32_t wordCategory(int32_t status)
+{
+    int32_t category = status / UBRK_WORD_NONE_LIMIT;
+
+    return 1U << (category < 0 ? 0 : category > 31 ? 31 : category);
+}
+
+/* Collects the start and end native offsets of the words of text whose
+ * rule status is in categories into tokens, which must have room for
+ * 2 * length values. Returns the number of words.
+ */
+static int32_t getWordTokens(BreakIterator *iterator, UText *text,
+                             uint32_t categories, int32_t *tokens,
+                             UErrorCode &status)
+{
+    int32_t count = 0;
+
+    iterator->setText(text, status);
+    if (U_FAILURE(status))
+        return 0;
+
+    int32_t start = iterator->first();
+    for (int32_t end = iterator->next(); end != BreakIterator::DONE;
+         start = end, end = iterator->next())
+    {
+        if (categories & wordCategory(iterator->getRuleStatus()))
+        {
+            tokens[count * 2] = start;
+            tokens[count * 2 + 1] = end;
+            count += 1;
+        }
+    }
+
+    iterator->setText(emptyText);
+
+    return count;
+}
+
+static PyObject *getWordIterator(const Locale &locale)
+{
+    PyObject *key = PyString_FromString(locale.getName());
+
+    if (key == NULL)
+        return NULL;
+
+    PyObject *iterator = wordIteratorCache.lookup(key);
+
+    if (iterator == NULL)
+    {
+        UErrorCode status = U_ZERO_ERROR;
+        BreakIterator *word =
+            BreakIterator::createWordInstance(locale, status);
+
+        if (U_FAILURE(status))
+        {
+            Py_DECREF(key);
+            return ICUException(status).reportError();
+        }
+
+        iterator = wrap_BreakIterator(word);
+        if (iterator != NULL && wordIteratorCache.insert(key, iterator) < 0)
+            Py_CLEAR(iterator);
+    }
+    Py_DECREF(key);
+
+    return iterator;
+}
+
+static PyObject *t_breakiterator_tokenize(PyTypeObject *type, PyObject *args)
+{
+    PyObject *text, *none;
+    Locale *locale;
+    int *statuses = NULL, statusCount = 0, spans = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 2:
+        if (!parseArgs(args, "KP", TYPE_CLASSID(Locale), &text, &locale))
+            break;
+        return PyErr_SetArgsError(type, "tokenize", args);
+      case 3:
+        if (!parseArgs(args, "KPN", TYPE_CLASSID(Locale), &text, &locale,
+                       &none))
+            break;
+        if (!parseArgs(args, "KPH", TYPE_CLASSID(Locale), &text, &locale,
+                       &statuses, &statusCount))
+            break;
+        return PyErr_SetArgsError(type, "tokenize", args);
+      case 4:
+        if (!parseArgs(args, "KPNb", TYPE_CLASSID(Locale), &text, &locale,
+                       &none, &spans))
+            break;
+        if (!parseArgs(args, "KPHb", TYPE_CLASSID(Locale), &text, &locale,
+                       &statuses, &statusCount, &spans))
+            break;
+        return PyErr_SetArgsError(type, "tokenize", args);
+      default:
+        return PyErr_SetArgsError(type, "tokenize", args);
+    }
+
+    // by default, every word but spaces and punctuation
+    uint32_t categories = ~wordCategory(UBRK_WORD_NONE);
+
+    if (statuses != NULL)
+    {
+        categories = 0;
+        for (int i = 0; i < statusCount; ++i)
+            categories |= wordCategory(statuses[i]);
+        delete[] statuses;
+    }
+
+    // a str is read in place, its words are sliced from it by code point
+    UText ut = UTEXT_INITIALIZER;
+    UnicodeString *u = NULL, _u;
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t length;
+
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+    if (PyUnicode_Check(text) && PyUnicode_READY(text) == 0)
+    {
+        openPythonText(&ut, text, status);
+        length = (int32_t) PyUnicode_GET_LENGTH(text);
+    }
+    else
+#endif
+    if (!parseArg(text, "S", &u, &_u))
+    {
+        utext_openConstUnicodeString(&ut, u, &status);
+        length = u->length();
+    }
+    else
+        return PyErr_SetArgsError(type, "tokenize", args);
+
+    PyObject *wordIterator = getWordIterator(*locale);
+
+    if (wordIterator == NULL)
+    {
+        utext_close(&ut);
+        return NULL;
+    }
+
+    int32_t *tokens = (int32_t *) malloc(
+        (length + 1) * (u != NULL && spans ? 4 : 2) * sizeof(int32_t));
+
+    if (tokens == NULL)
+    {
+        utext_close(&ut);
+        Py_DECREF(wordIterator);
+        return PyErr_NoMemory();
+    }
+
+    BreakIterator *iterator = takeWordIterator(wordIterator);
+    int32_t count;
+
+    if (iterator == NULL)
+    {
+        free(tokens);
+        utext_close(&ut);
+        Py_DECREF(wordIterator);
+        return PyErr_NoMemory();
+    }
+
+    ALLOW_THREADS_CALL(
+        (u == NULL || u == &_u) && allowThreads(length),
+        count = getWordTokens(iterator, &ut, categories, tokens, status));
+
+    returnWordIterator(wordIterator, iterator);
+    utext_close(&ut);
+    Py_DECREF(wordIterator);
+
+    if (U_FAILURE(status))
+    {
+        free(tokens);
+        return ICUException(status).reportError();
+    }
+
+    int32_t *codePoints = tokens;
+
+    if (u != NULL && spans)
+    {
+        const UChar *chars = u->getBuffer();
+        int32_t prev = 0, cp = 0;
+
+        codePoints = tokens + (length + 1) * 2;
+        for (int32_t i = 0; i < count * 2; ++i)
+        {
+            cp += u_countChar32(chars + prev, tokens[i] - prev);
+            prev = tokens[i];
+            codePoints[i] = cp;
+        }
+    }
+
+    PyObject *result = PyList_New(count);
+
+    for (int32_t i = 0; result != NULL && i < count; ++i)
+    {
+        PyObject *token;
+
+        if (u == NULL)
+            token = PyUnicode_Substring(text, tokens[i * 2], tokens[i * 2 + 1]);
+        else
+            token = PyUnicode_FromUnicodeString(
+                u->getBuffer() + tokens[i * 2],
+                tokens[i * 2 + 1] - tokens[i * 2]);
+
+        if (token != NULL && spans)
+            token = Py_BuildValue("(Nii)", token,
+                                  codePoints[i * 2], codePoints[i * 2 + 1]);
+
+        if (token == NULL)
+            Py_CLEAR(result);
+        else
+            PyList_SET_ITEM(result, i, token);
+    }
+
+    free(tokens);
+
+    return result;
+}
+
+#endif
+
 DEFINE_RICHCMP(BreakIterator, t_breakiterator)
 
 
@@ -1459,4 +1964,18 @@ void _init_iterators(PyObject *m)
     INSTALL_STATIC_INT(CharacterIterator, kEnd);
 
     INSTALL_STATIC_INT(CollationElementIterator, NULLORDER);
+
+#if U_ICU_VERSION_HEX >= VERSION_HEX(52, 0, 0)
+    INSTALL_CONSTANTS_TYPE(UWordBreak, m);
+    INSTALL_ENUM(UWordBreak, "NONE", UBRK_WORD_NONE);
+    INSTALL_ENUM(UWordBreak, "NONE_LIMIT", UBRK_WORD_NONE_LIMIT);
+    INSTALL_ENUM(UWordBreak, "NUMBER", UBRK_WORD_NUMBER);
+    INSTALL_ENUM(UWordBreak, "NUMBER_LIMIT", UBRK_WORD_NUMBER_LIMIT);
+    INSTALL_ENUM(UWordBreak, "LETTER", UBRK_WORD_LETTER);
+    INSTALL_ENUM(UWordBreak, "LETTER_LIMIT", UBRK_WORD_LETTER_LIMIT);
+    INSTALL_ENUM(UWordBreak, "KANA", UBRK_WORD_KANA);
+    INSTALL_ENUM(UWordBreak, "KANA_LIMIT", UBRK_WORD_KANA_LIMIT);
+    INSTALL_ENUM(UWordBreak, "IDEO", UBRK_WORD_IDEO);
+    INSTALL_ENUM(UWordBreak, "IDEO_LIMIT", UBRK_WORD_IDEO_LIMIT);
+#endif
 }
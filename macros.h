@@ -148,6 +148,43 @@ PyObject *make_descriptor(PyObject *(*get)(PyObject *));
             return -1;                                                  \
     }
 
+/* The GIL is released around action only when allow is true, see
+ * allowThreads() in common.h. Action may only use ICU objects that are
+ * thread-safe or locked with an ObjectLocker, and memory not reachable
+ * from Python code.
+ */
+#define ALLOW_THREADS_CALL(allow, action)                               \
+    {                                                                   \
+        if (allow)                                                      \
+        {                                                               \
+            Py_BEGIN_ALLOW_THREADS                                      \
+            action;                                                     \
+            Py_END_ALLOW_THREADS                                        \
+        }                                                               \
+        else                                                            \
+        {                                                               \
+            action;                                                     \
+        }                                                               \
+    }
+
+#define STATUS_ALLOW_THREADS_CALL(allow, action)                        \
+    {                                                                   \
+        UErrorCode status = U_ZERO_ERROR;                               \
+        ALLOW_THREADS_CALL(allow, action);                              \
+        if (U_FAILURE(status))                                          \
+            return ICUException(status).reportError();                  \
+    }
+
+#define STATUS_PYTHON_ALLOW_THREADS_CALL(allow, action)                 \
+    {                                                                   \
+        UErrorCode status = U_ZERO_ERROR;                               \
+        ALLOW_THREADS_CALL(allow, action);                              \
+        if (U_FAILURE(status))                                          \
+            return ICUException(status).reportError();                  \
+        if (PyErr_Occurred())                                           \
+            return NULL;                                                \
+    }
+
 
 #define DECLARE_METHOD(type, name, flags)                               \
     { #name, (PyCFunction) type##_##name, flags, "" }
@@ -118,6 +118,8 @@ static PyObject *t_normalizer2_hasBoundaryBefore(t_normalizer2 *self,
 static PyObject *t_normalizer2_hasBoundaryAfter(t_normalizer2 *self,
                                                 PyObject *arg);
 static PyObject *t_normalizer2_isInert(t_normalizer2 *self, PyObject *arg);
+static PyObject *t_normalizer2_normalizeStream(t_normalizer2 *self,
+                                               PyObject *args);
 static PyObject *t_normalizer2_getInstance(PyTypeObject *type, PyObject *args);
 
 #if U_ICU_VERSION_HEX >= VERSION_HEX(49, 0, 0)
@@ -138,6 +140,7 @@ static PyMethodDef t_normalizer2_methods[] = {
     DECLARE_METHOD(t_normalizer2, hasBoundaryBefore, METH_O),
     DECLARE_METHOD(t_normalizer2, hasBoundaryAfter, METH_O),
     DECLARE_METHOD(t_normalizer2, isInert, METH_O),
+    DECLARE_METHOD(t_normalizer2, normalizeStream, METH_VARARGS),
     DECLARE_METHOD(t_normalizer2, getInstance, METH_VARARGS | METH_CLASS),
 #if U_ICU_VERSION_HEX >= VERSION_HEX(49, 0, 0)
     DECLARE_METHOD(t_normalizer2, getNFCInstance, METH_NOARGS | METH_CLASS),
@@ -184,6 +187,67 @@ DECLARE_TYPE(FilteredNormalizer2, t_filterednormalizer2, Normalizer2,
              FilteredNormalizer2, t_filterednormalizer2_init,
              t_filterednormalizer2_dealloc)
 
+
+/* Normalizer2Stream, returned by Normalizer2.normalizeStream() */
+
+#define NORMALIZER2_STREAM_CHUNK_SIZE 65536
+
+struct t_normalizer2stream {
+    PyObject_HEAD
+    t_normalizer2 *normalizer;
+    PyObject *source;          /* an iterator or a file's read() method */
+    int chunkSize;             /* > 0 when source is a read() method */
+    int done;
+    int running;               /* pending is in use without the GIL */
+    UnicodeString *pending;    /* text not yet normalized */
+};
+
+static void t_normalizer2stream_dealloc(t_normalizer2stream *self);
+static PyObject *t_normalizer2stream_iter(t_normalizer2stream *self);
+static PyObject *t_normalizer2stream_iter_next(t_normalizer2stream *self);
+
+static PyTypeObject Normalizer2StreamType_ = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "icu.Normalizer2Stream",                     /* tp_name */
+    sizeof(t_normalizer2stream),                 /* tp_basicsize */
+    0,                                           /* tp_itemsize */
+    (destructor) t_normalizer2stream_dealloc,    /* tp_dealloc */
+    0,                                           /* tp_print */
+    0,                                           /* tp_getattr */
+    0,                                           /* tp_setattr */
+    0,                                           /* tp_compare */
+    0,                                           /* tp_repr */
+    0,                                           /* tp_as_number */
+    0,                                           /* tp_as_sequence */
+    0,                                           /* tp_as_mapping */
+    0,                                           /* tp_hash  */
+    0,                                           /* tp_call */
+    0,                                           /* tp_str */
+    0,                                           /* tp_getattro */
+    0,                                           /* tp_setattro */
+    0,                                           /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                          /* tp_flags */
+    "Normalizer2Stream objects",                 /* tp_doc */
+    0,                                           /* tp_traverse */
+    0,                                           /* tp_clear */
+    0,                                           /* tp_richcompare */
+    0,                                           /* tp_weaklistoffset */
+    (getiterfunc) t_normalizer2stream_iter,      /* tp_iter */
+    (iternextfunc) t_normalizer2stream_iter_next,/* tp_iternext */
+    0,                                           /* tp_methods */
+    0,                                           /* tp_members */
+    0,                                           /* tp_getset */
+    0,                                           /* tp_base */
+    0,                                           /* tp_dict */
+    0,                                           /* tp_descr_get */
+    0,                                           /* tp_descr_set */
+    0,                                           /* tp_dictoffset */
+    0,                                           /* tp_init */
+    0,                                           /* tp_alloc */
+    0,                                           /* tp_new */
+    0,                                           /* tp_free */
+};
+
 #endif
 
 
@@ -347,7 +411,9 @@ static PyObject *t_normalizer_normalize(PyTypeObject *type, PyObject *args)
 
     if (!parseArgs(args, "Sii", &u, &_u, &mode, &options))
     {
-        STATUS_CALL(Normalizer::normalize(*u, mode, options, target, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            Normalizer::normalize(*u, mode, options, target, status));
         return PyUnicode_FromUnicodeString(&target);
     }
 
@@ -362,7 +428,9 @@ static PyObject *t_normalizer_compose(PyTypeObject *type, PyObject *args)
 
     if (!parseArgs(args, "SBi", &u, &_u, &compat, &options))
     {
-        STATUS_CALL(Normalizer::compose(*u, compat, options, target, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            Normalizer::compose(*u, compat, options, target, status));
         return PyUnicode_FromUnicodeString(&target);
     }
 
@@ -377,7 +445,9 @@ static PyObject *t_normalizer_decompose(PyTypeObject *type, PyObject *args)
 
     if (!parseArgs(args, "SBi", &u, &_u, &compat, &options))
     {
-        STATUS_CALL(Normalizer::decompose(*u, compat, options, target, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            Normalizer::decompose(*u, compat, options, target, status));
         return PyUnicode_FromUnicodeString(&target);
     }
 
@@ -386,7 +456,7 @@ static PyObject *t_normalizer_decompose(PyTypeObject *type, PyObject *args)
 
 static PyObject *t_normalizer_quickCheck(PyTypeObject *type, PyObject *args)
 {
-    UnicodeString *u, *_u;
+    UnicodeString *u, _u;
     UNormalizationMode mode;
     int32_t options;
 
@@ -396,7 +466,9 @@ static PyObject *t_normalizer_quickCheck(PyTypeObject *type, PyObject *args)
         {
             UNormalizationCheckResult uncr;
             
-            STATUS_CALL(uncr = Normalizer::quickCheck(*u, mode, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                uncr = Normalizer::quickCheck(*u, mode, status));
             return PyInt_FromLong(uncr);
         }
         break;
@@ -405,8 +477,9 @@ static PyObject *t_normalizer_quickCheck(PyTypeObject *type, PyObject *args)
         {
             UNormalizationCheckResult uncr;
             
-            STATUS_CALL(uncr = Normalizer::quickCheck(*u, mode, options,
-                                                      status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                uncr = Normalizer::quickCheck(*u, mode, options, status));
             return PyInt_FromLong(uncr);
         }
         break;
@@ -417,7 +490,7 @@ static PyObject *t_normalizer_quickCheck(PyTypeObject *type, PyObject *args)
 
 static PyObject *t_normalizer_isNormalized(PyTypeObject *type, PyObject *args)
 {
-    UnicodeString *u, *_u;
+    UnicodeString *u, _u;
     UNormalizationMode mode;
     int32_t options;
     UBool b;
@@ -426,15 +499,18 @@ static PyObject *t_normalizer_isNormalized(PyTypeObject *type, PyObject *args)
       case 2:
         if (!parseArgs(args, "Si", &u, &_u, &mode))
         {
-            STATUS_CALL(b = Normalizer::isNormalized(*u, mode, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                b = Normalizer::isNormalized(*u, mode, status));
             Py_RETURN_BOOL(b);
         }
         break;
       case 3:
         if (!parseArgs(args, "Sii", &u, &_u, &mode, &options))
         {
-            STATUS_CALL(b = Normalizer::isNormalized(*u, mode, options,
-                                                     status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                b = Normalizer::isNormalized(*u, mode, options, status));
             Py_RETURN_BOOL(b);
         }
         break;
@@ -445,16 +521,17 @@ static PyObject *t_normalizer_isNormalized(PyTypeObject *type, PyObject *args)
 
 static PyObject *t_normalizer_concatenate(PyTypeObject *type, PyObject *args)
 {
-    UnicodeString *u0, *_u0;
-    UnicodeString *u1, *_u1;
+    UnicodeString *u0, _u0;
+    UnicodeString *u1, _u1;
     UnicodeString u;
     UNormalizationMode mode;
     int32_t options;
 
     if (!parseArgs(args, "SSii", &u0, &_u0, &u1, &_u1, &mode, &options))
     {
-        STATUS_CALL(Normalizer::concatenate(*u0, *u1, u,
-                                            mode, options, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u0, &_u0, u1, &_u1),
+            Normalizer::concatenate(*u0, *u1, u, mode, options, status));
         return PyUnicode_FromUnicodeString(&u);
     }
 
@@ -463,13 +540,15 @@ static PyObject *t_normalizer_concatenate(PyTypeObject *type, PyObject *args)
 
 static PyObject *t_normalizer_compare(PyTypeObject *type, PyObject *args)
 {
-    UnicodeString *u0, *_u0;
-    UnicodeString *u1, *_u1;
+    UnicodeString *u0, _u0;
+    UnicodeString *u1, _u1;
     int32_t options, n;
 
     if (!parseArgs(args, "SSi", &u0, &_u0, &u1, &_u1, &options))
     {
-        STATUS_CALL(n = Normalizer::compare(*u0, *u1, options, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u0, &_u0, u1, &_u1),
+            n = Normalizer::compare(*u0, *u1, options, status));
         return PyInt_FromLong(n);
     }
 
@@ -505,17 +584,199 @@ static PyObject *t_normalizer_iter_next(t_normalizer *self)
 
 /* Normalizer2 */
 
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+
+#define PEP393_FAST_PATHS
+
+/* The Latin-1 characters that are normalized and that have a normalization
+ * boundary before them: a string made only of such characters is normalized.
+ * Masks are only cached for the shared instances returned by getInstance()
+ * and friends, a FilteredNormalizer2 is owned and may be freed.
+ */
+#define LATIN1_MASK_CACHE_SIZE 8
+
+struct latin1Mask {
+    const Normalizer2 *normalizer;
+    bool ascii;                 /* all ASCII characters are in the mask */
+    uint32_t bits[8];
+};
+
+static latin1Mask latin1Masks[LATIN1_MASK_CACHE_SIZE];
+
+static const latin1Mask *getLatin1Mask(t_normalizer2 *self)
+{
+    if (self->flags & T_OWNED)
+        return NULL;
+
+    for (int i = 0; i < LATIN1_MASK_CACHE_SIZE; ++i) {
+        latin1Mask *mask = &latin1Masks[i];
+
+        if (mask->normalizer == self->object)
+            return mask;
+
+        if (mask->normalizer == NULL)
+        {
+            UErrorCode status = U_ZERO_ERROR;
+
+            mask->ascii = true;
+            for (UChar c = 0; c < 256; ++c) {
+                if (self->object->hasBoundaryBefore(c) &&
+                    self->object->quickCheck(UnicodeString(c),
+                                             status) == UNORM_YES)
+                    mask->bits[c >> 5] |= 1U << (c & 31);
+                else if (c < 128)
+                    mask->ascii = false;
+            }
+
+            if (U_FAILURE(status))
+            {
+                memset(mask->bits, 0, sizeof(mask->bits));
+                return NULL;
+            }
+
+            mask->normalizer = self->object;
+            return mask;
+        }
+    }
+
+    return NULL;
+}
+
+/* Returns the start of the part of a str that is left to check or to
+ * normalize with ICU, at a normalization boundary. The characters before
+ * it are normalized and are neither converted nor copied.
+ */
+static Py_ssize_t normalizedPrefix(t_normalizer2 *self, PyObject *object)
+{
+    if (PyUnicode_READY(object) != 0)
+    {
+        PyErr_Clear();
+        return 0;
+    }
+
+    if (PyUnicode_KIND(object) != PyUnicode_1BYTE_KIND)
+        return 0;
+
+    const latin1Mask *mask = getLatin1Mask(self);
+
+    if (mask == NULL)
+        return 0;
+
+    Py_ssize_t length = PyUnicode_GET_LENGTH(object);
+
+    if (mask->ascii && PyUnicode_IS_ASCII(object))
+        return length;
+
+    const Py_UCS1 *chars = PyUnicode_1BYTE_DATA(object);
+
+    for (Py_ssize_t i = 0; i < length; ++i) {
+        Py_UCS1 c = chars[i];
+
+        // the previous character has a boundary before it
+        if (!((mask->bits[c >> 5] >> (c & 31)) & 1))
+            return i > 0 ? i - 1 : 0;
+    }
+
+    return length;
+}
+
+static int32_t normalizeSuffix(const Normalizer2 *normalizer,
+                               const UnicodeString &u, UnicodeString &dest,
+                               UErrorCode &status)
+{
+    int32_t end = normalizer->spanQuickCheckYes(u, status);
+
+    if (U_SUCCESS(status) && end < u.length())
+    {
+        dest.setTo(u, 0, end);
+        normalizer->normalizeSecondAndAppend(dest, u.tempSubString(end),
+                                             status);
+    }
+
+    return end;
+}
+
+static PyObject *normalizeStr(t_normalizer2 *self, PyObject *object)
+{
+    Py_ssize_t start = normalizedPrefix(self, object);
+    Py_ssize_t length = PyUnicode_GET_LENGTH(object);
+
+    if (start == length)
+    {
+        Py_INCREF(object);
+        return object;
+    }
+
+    PyObject *suffix = PyUnicode_Substring(object, start, length);
+    UnicodeString *u, _u, dest;
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t end;
+
+    if (suffix == NULL)
+        return NULL;
+
+    parseArg(suffix, "S", &u, &_u);
+    ALLOW_THREADS_CALL(
+        allowThreads(u, &_u),
+        end = normalizeSuffix(self->object, *u, dest, status));
+
+    if (U_FAILURE(status))
+    {
+        Py_DECREF(suffix);
+        return ICUException(status).reportError();
+    }
+
+    // a quick check "maybe" may still turn out to be normalized
+    if (end == u->length() || dest == *u)
+    {
+        Py_DECREF(suffix);
+        Py_INCREF(object);
+        return object;
+    }
+    Py_DECREF(suffix);
+
+    PyObject *result = PyUnicode_FromUnicodeString(&dest);
+
+    if (result != NULL && start > 0)
+    {
+        PyObject *prefix = PyUnicode_Substring(object, 0, start);
+
+        if (prefix == NULL)
+        {
+            Py_DECREF(result);
+            return NULL;
+        }
+
+        PyObject *concat = PyUnicode_Concat(prefix, result);
+
+        Py_DECREF(prefix);
+        Py_DECREF(result);
+
+        return concat;
+    }
+
+    return result;
+}
+
+#endif
+
 static PyObject *t_normalizer2_normalize(t_normalizer2 *self, PyObject *args)
 {
     UnicodeString *u, _u, *result;
 
     switch (PyTuple_Size(args)) {
       case 1:
+#ifdef PEP393_FAST_PATHS
+        if (PyUnicode_Check(PyTuple_GET_ITEM(args, 0)))
+            return normalizeStr(self, PyTuple_GET_ITEM(args, 0));
+#endif
         if (!parseArgs(args, "S", &u, &_u))
         {
             UnicodeString dest;
 
-            STATUS_CALL(self->object->normalize(*u, dest, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                self->object->normalize(*u, dest, status));
             return PyUnicode_FromUnicodeString(&dest);
         }
         break;
@@ -563,11 +824,37 @@ static PyObject *t_normalizer2_isNormalized(t_normalizer2 *self, PyObject *arg)
 {
     UnicodeString *u, _u;
 
+#ifdef PEP393_FAST_PATHS
+    if (PyUnicode_Check(arg))
+    {
+        Py_ssize_t start = normalizedPrefix(self, arg);
+        Py_ssize_t length = PyUnicode_GET_LENGTH(arg);
+
+        if (start == length)
+            Py_RETURN_TRUE;
+
+        if (start > 0)
+        {
+            PyObject *suffix = PyUnicode_Substring(arg, start, length);
+
+            if (suffix == NULL)
+                return NULL;
+
+            PyObject *result = t_normalizer2_isNormalized(self, suffix);
+
+            Py_DECREF(suffix);
+            return result;
+        }
+    }
+#endif
+
     if (!parseArg(arg, "S", &u, &_u))
     {
         UBool b;
 
-        STATUS_CALL(b = self->object->isNormalized(*u, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            b = self->object->isNormalized(*u, status));
         Py_RETURN_BOOL(b);
     }
 
@@ -578,11 +865,37 @@ static PyObject *t_normalizer2_quickCheck(t_normalizer2 *self, PyObject *arg)
 {
     UnicodeString *u, _u;
 
+#ifdef PEP393_FAST_PATHS
+    if (PyUnicode_Check(arg))
+    {
+        Py_ssize_t start = normalizedPrefix(self, arg);
+        Py_ssize_t length = PyUnicode_GET_LENGTH(arg);
+
+        if (start == length)
+            return PyInt_FromLong(UNORM_YES);
+
+        if (start > 0)
+        {
+            PyObject *suffix = PyUnicode_Substring(arg, start, length);
+
+            if (suffix == NULL)
+                return NULL;
+
+            PyObject *result = t_normalizer2_quickCheck(self, suffix);
+
+            Py_DECREF(suffix);
+            return result;
+        }
+    }
+#endif
+
     if (!parseArg(arg, "S", &u, &_u))
     {
         UNormalizationCheckResult uncr;
 
-        STATUS_CALL(uncr = self->object->quickCheck(*u, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            uncr = self->object->quickCheck(*u, status));
         return PyInt_FromLong(uncr);
     }
 
@@ -598,7 +911,9 @@ static PyObject *t_normalizer2_spanQuickCheckYes(t_normalizer2 *self,
     {
         int32_t end;
 
-        STATUS_CALL(end = self->object->spanQuickCheckYes(*u, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(u, &_u),
+            end = self->object->spanQuickCheckYes(*u, status));
         return PyInt_FromLong(end);
     }
 
@@ -670,6 +985,89 @@ static PyObject *t_normalizer2_isInert(t_normalizer2 *self, PyObject *arg)
     return PyErr_SetArgsError((PyObject *) self, "isInert", arg);
 }
 
+/* Bytes aren't decoded by normalizeStream(), a UTF-8 sequence could be split
+ * between two chunks. Under python 2, str is bytes and is accepted.
+ */
+static bool isBytesChunk(PyObject *chunk)
+{
+#if PY_MAJOR_VERSION >= 3
+    return PyBytes_Check(chunk) || PyByteArray_Check(chunk);
+#else
+    return PyByteArray_Check(chunk);
+#endif
+}
+
+static PyObject *newNormalizer2Stream(t_normalizer2 *self, PyObject *source,
+                                      int chunkSize)
+{
+    PyObject *read = NULL;
+
+    /* a text file object is read by chunks of chunkSize characters,
+     * anything else is iterated, a single string is one chunk
+     */
+    if (PyUnicode_Check(source))
+    {
+        PyObject *tuple = PyTuple_Pack(1, source);
+
+        if (tuple == NULL)
+            return NULL;
+
+        source = PyObject_GetIter(tuple);
+        Py_DECREF(tuple);
+    }
+    else if ((read = PyObject_GetAttrString(source, "read")) != NULL)
+        source = read;
+    else
+    {
+        PyErr_Clear();
+        source = PyObject_GetIter(source);
+    }
+
+    if (source == NULL)
+        return NULL;
+
+    t_normalizer2stream *stream =
+        PyObject_New(t_normalizer2stream, &Normalizer2StreamType_);
+
+    if (stream == NULL)
+    {
+        Py_DECREF(source);
+        return NULL;
+    }
+
+    Py_INCREF(self);
+    stream->normalizer = self;
+    stream->source = source;
+    stream->chunkSize = read != NULL ? chunkSize : 0;
+    stream->done = 0;
+    stream->running = 0;
+    stream->pending = new UnicodeString();
+
+    return (PyObject *) stream;
+}
+
+static PyObject *t_normalizer2_normalizeStream(t_normalizer2 *self,
+                                               PyObject *args)
+{
+    PyObject *source;
+    int chunkSize;
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "K", &source) && !isBytesChunk(source))
+            return newNormalizer2Stream(self, source,
+                                        NORMALIZER2_STREAM_CHUNK_SIZE);
+        break;
+      case 2:
+        if (!parseArgs(args, "Ki", &source, &chunkSize) &&
+            !isBytesChunk(source) && chunkSize > 0)
+            return newNormalizer2Stream(self, source, chunkSize);
+        break;
+    }
+
+    return PyErr_SetArgsError((PyObject *) self, "normalizeStream", args);
+}
+
 
 static PyObject *t_normalizer2_getInstance(PyTypeObject *type, PyObject *args)
 {
@@ -731,6 +1129,135 @@ static PyObject *t_normalizer2_getNFKCCasefoldInstance(PyTypeObject *type)
 
 #endif
 
+/* Normalizer2Stream */
+
+static void t_normalizer2stream_dealloc(t_normalizer2stream *self)
+{
+    delete self->pending;
+    self->pending = NULL;
+
+    Py_CLEAR(self->normalizer);
+    Py_CLEAR(self->source);
+    PyObject_Del(self);
+}
+
+static PyObject *t_normalizer2stream_iter(t_normalizer2stream *self)
+{
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+/* Returns the start of the last code point in text that has a normalization
+ * boundary before it, text before that point normalizes independently from
+ * text after it. Returns 0 if there is no such point past the first one.
+ */
+static int32_t lastBoundaryBefore(const Normalizer2 *normalizer,
+                                  const UnicodeString &text)
+{
+    const UChar *chars = text.getBuffer();
+    int32_t i = text.length();
+
+    while (i > 0) {
+        UChar32 c;
+
+        U16_PREV(chars, 0, i, c);
+        if (i > 0 && normalizer->hasBoundaryBefore(c))
+            return i;
+    }
+
+    return 0;
+}
+
+static PyObject *t_normalizer2stream_iter_next(t_normalizer2stream *self)
+{
+    const Normalizer2 *normalizer = self->normalizer->object;
+    UnicodeString &pending = *self->pending;
+
+    if (self->running)
+    {
+        PyErr_SetString(PyExc_ValueError, "stream already executing");
+        return NULL;
+    }
+
+    while (!self->done) {
+        PyObject *chunk;
+
+        if (self->chunkSize > 0)
+        {
+            chunk = PyObject_CallFunction(self->source, (char *) "i",
+                                          self->chunkSize);
+            if (chunk == NULL)
+                return NULL;
+
+            Py_ssize_t length = PyObject_Size(chunk);
+
+            if (length < 0)
+                PyErr_Clear();
+            else if (length == 0)
+            {
+                Py_DECREF(chunk);
+                chunk = NULL;
+            }
+        }
+        else
+        {
+            chunk = PyIter_Next(self->source);
+            if (chunk == NULL && PyErr_Occurred())
+                return NULL;
+        }
+
+        int32_t end;
+
+        if (chunk == NULL)
+        {
+            self->done = 1;
+            end = pending.length();
+        }
+        else
+        {
+            UnicodeString *u, _u;
+
+            if (isBytesChunk(chunk) || parseArg(chunk, "S", &u, &_u))
+            {
+                PyErr_Format(PyExc_TypeError,
+                             "normalizeStream() chunks must be str, not %s",
+                             Py_TYPE(chunk)->tp_name);
+                Py_DECREF(chunk);
+                return NULL;
+            }
+
+            pending.append(*u);
+            Py_DECREF(chunk);
+
+            end = lastBoundaryBefore(normalizer, pending);
+        }
+
+        if (end > 0)
+        {
+            /* the text up to end is normalized in place, without copy */
+            UnicodeString text(false, pending.getBuffer(), end);
+            UnicodeString dest;
+
+            UErrorCode status = U_ZERO_ERROR;
+
+            self->running = 1;
+            ALLOW_THREADS_CALL(
+                allowThreads(end),
+                normalizer->normalize(text, dest, status));
+            self->running = 0;
+
+            pending.remove(0, end);
+            if (U_FAILURE(status))
+                return ICUException(status).reportError();
+
+            if (dest.length() > 0)
+                return PyUnicode_FromUnicodeString(&dest);
+        }
+    }
+
+    return NULL;
+}
+
 /* FilteredNormalizer2 */
 
 static int t_filterednormalizer2_init(t_filterednormalizer2 *self,
@@ -767,6 +1294,7 @@ void _init_normalizer(PyObject *m)
 #if U_ICU_VERSION_HEX >= 0x04040000
     REGISTER_TYPE(Normalizer2, m);
     REGISTER_TYPE(FilteredNormalizer2, m);
+    PyType_Ready(&Normalizer2StreamType_);
 #endif
 
     INSTALL_CONSTANTS_TYPE(UNormalizationMode, m);
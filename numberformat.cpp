@@ -796,6 +796,8 @@ static PyObject *t_localizednumberformatter_formatDouble(
     t_localizednumberformatter *self, PyObject *arg);
 static PyObject *t_localizednumberformatter_formatDecimal(
     t_localizednumberformatter *self, PyObject *arg);
+static PyObject *t_localizednumberformatter_formatMany(
+    t_localizednumberformatter *self, PyObject *args);
 
 #if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
 static PyObject *t_localizednumberformatter_formatIntToValue(
@@ -810,6 +812,14 @@ static PyObject *t_localizednumberformatter_formatDecimalToValue(
 static PyObject *t_localizednumberformatter_usage(
     t_localizednumberformatter *self, PyObject *arg);
 #endif
+#if U_ICU_VERSION_HEX >= VERSION_HEX(62, 0, 0)
+static PyObject *t_localizednumberformatter_getInstance(PyTypeObject *type,
+                                                        PyObject *args);
+static PyObject *t_localizednumberformatter_getCacheInfo(PyTypeObject *type);
+static PyObject *t_localizednumberformatter_setCacheSize(PyTypeObject *type,
+                                                         PyObject *arg);
+static PyObject *t_localizednumberformatter_clearCache(PyTypeObject *type);
+#endif
 
 static PyMethodDef t_localizednumberformatter_methods[] = {
     DECLARE_METHOD(t_localizednumberformatter, unit, METH_O),
@@ -837,6 +847,7 @@ static PyMethodDef t_localizednumberformatter_methods[] = {
     DECLARE_METHOD(t_localizednumberformatter, formatInt, METH_O),
     DECLARE_METHOD(t_localizednumberformatter, formatDouble, METH_O),
     DECLARE_METHOD(t_localizednumberformatter, formatDecimal, METH_O),
+    DECLARE_METHOD(t_localizednumberformatter, formatMany, METH_VARARGS),
 #if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
     DECLARE_METHOD(t_localizednumberformatter, formatIntToValue, METH_O),
     DECLARE_METHOD(t_localizednumberformatter, formatDoubleToValue, METH_O),
@@ -844,6 +855,16 @@ static PyMethodDef t_localizednumberformatter_methods[] = {
 #endif
 #if U_ICU_VERSION_HEX >= VERSION_HEX(68, 0, 0)
     DECLARE_METHOD(t_localizednumberformatter, usage, METH_O),
+#endif
+#if U_ICU_VERSION_HEX >= VERSION_HEX(62, 0, 0)
+    DECLARE_METHOD(t_localizednumberformatter, getInstance,
+                   METH_VARARGS | METH_CLASS),
+    DECLARE_METHOD(t_localizednumberformatter, getCacheInfo,
+                   METH_NOARGS | METH_CLASS),
+    DECLARE_METHOD(t_localizednumberformatter, setCacheSize,
+                   METH_O | METH_CLASS),
+    DECLARE_METHOD(t_localizednumberformatter, clearCache,
+                   METH_NOARGS | METH_CLASS),
 #endif
     { NULL, NULL, 0, NULL }
 };
@@ -4098,6 +4119,166 @@ static PyObject *t_localizednumberformatter_formatDecimal(
     return PyErr_SetArgsError((PyObject *) self, "formatDecimal", arg);
 }
 
+static void formatNumbers(const LocalizedNumberFormatter *formatter,
+                          const void *values, bool doubles, Py_ssize_t count,
+                          UnicodeString *strings, UErrorCode &status)
+{
+    for (Py_ssize_t i = 0; i < count && U_SUCCESS(status); ++i) {
+        if (doubles)
+            strings[i] = formatter->formatDouble(
+#if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
+                ((const double *) values)[i], status).toString(status);
+#else
+                ((const double *) values)[i], status).toString();
+#endif
+        else
+            strings[i] = formatter->formatInt(
+#if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
+                ((const int64_t *) values)[i], status).toString(status);
+#else
+                ((const int64_t *) values)[i], status).toString();
+#endif
+    }
+}
+
+static void formatNumber(const LocalizedNumberFormatter *formatter,
+                         PyObject *value, UnicodeString &string,
+                         UErrorCode &status)
+{
+    PY_LONG_LONG l;
+    double d;
+
+    if (PyFloat_Check(value) && !parseArg(value, "d", &d))
+    {
+        formatNumbers(formatter, &d, true, 1, &string, status);
+        return;
+    }
+
+    if (PyLong_Check(value) || PyInt_Check(value))
+    {
+        l = PyLong_AsLongLong(value);
+        if (!(l == -1 && PyErr_Occurred()))
+        {
+            int64_t n = (int64_t) l;
+
+            formatNumbers(formatter, &n, false, 1, &string, status);
+            return;
+        }
+        PyErr_Clear();
+    }
+
+    // anything else, such as a Decimal, is formatted from its string form
+    PyObject *str = PyObject_Str(value);
+    charsArg decimal;
+
+    if (str == NULL)
+        return;
+
+    if (!parseArg(str, "n", &decimal))
+#if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
+        string = formatter->formatDecimal(
+            decimal.c_str(), status).toString(status);
+#else
+        string = formatter->formatDecimal(decimal.c_str(), status).toString();
+#endif
+
+    Py_DECREF(str);
+}
+
+static PyObject *t_localizednumberformatter_formatMany(
+    t_localizednumberformatter *self, PyObject *args)
+{
+    PyObject *values, *result;
+    Py_buffer view;
+    int packed = 0;
+
+    switch (PyTuple_Size(args)) {
+      case 2:
+        packed = PyObject_IsTrue(PyTuple_GET_ITEM(args, 1));
+        if (packed < 0)
+            return NULL;
+        /* fall through */
+      case 1:
+        values = PyTuple_GET_ITEM(args, 0);
+        break;
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    UnicodeString *strings;
+    Py_ssize_t count;
+
+    if (PyObject_CheckBuffer(values))
+    {
+        if (PyObject_GetBuffer(values, &view,
+                               PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+        {
+            PyErr_Clear();
+            return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+        }
+
+        bool doubles = isNativeFormat(&view, 'd', sizeof(double));
+
+        if (!(doubles ||
+              isNativeFormat(&view, 'q', sizeof(int64_t)) ||
+              isNativeFormat(&view, 'l', sizeof(int64_t))))
+        {
+            PyBuffer_Release(&view);
+            return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+        }
+
+        count = view.len / view.itemsize;
+        strings = new UnicodeString[count + 1];
+
+        ALLOW_THREADS_CALL(
+            count >= ALLOW_THREADS_MIN_LENGTH,
+            formatNumbers(self->object, view.buf, doubles, count, strings,
+                          status));
+
+        PyBuffer_Release(&view);
+    }
+    else if (PySequence_Check(values) &&
+             !PyBytes_Check(values) && !PyUnicode_Check(values))
+    {
+        PyObject *seq = PySequence_Fast(values, "");
+
+        if (seq == NULL)
+            return NULL;
+
+        count = PySequence_Fast_GET_SIZE(seq);
+        strings = new UnicodeString[count + 1];
+
+        for (Py_ssize_t i = 0; i < count && U_SUCCESS(status); ++i) {
+            formatNumber(self->object, PySequence_Fast_GET_ITEM(seq, i),
+                         strings[i], status);
+            if (PyErr_Occurred())
+                break;
+        }
+
+        Py_DECREF(seq);
+
+        if (PyErr_Occurred())
+        {
+            delete[] strings;
+            return NULL;
+        }
+    }
+    else
+        return PyErr_SetArgsError((PyObject *) self, "formatMany", args);
+
+    if (U_FAILURE(status))
+    {
+        delete[] strings;
+        return ICUException(status).reportError();
+    }
+
+    result = fromUnicodeStrings(strings, count, packed);
+    delete[] strings;
+
+    return result;
+}
+
 #if U_ICU_VERSION_HEX >= VERSION_HEX(64, 0, 0)
 
 static PyObject *t_localizednumberformatter_formatIntToValue(
@@ -4189,6 +4370,89 @@ static PyObject *t_localizednumberformatter_usage(
 
 #endif  // ICU >= 68
 
+#if U_ICU_VERSION_HEX >= VERSION_HEX(62, 0, 0)
+
+/* A cache of formatters keyed by (skeleton, locale name). The cached python
+ * objects are shared by all callers, which is safe since
+ * LocalizedNumberFormatter is immutable.
+ */
+static LRUCache formatterCache(64);
+
+static PyObject *t_localizednumberformatter_getInstance(PyTypeObject *type,
+                                                        PyObject *args)
+{
+    UnicodeString *u, _u;
+    Locale *locale = NULL;
+    charsArg id;
+    PyObject *key;
+
+    // a locale id is part of the key as given, only parsed on a miss
+    if (!parseArgs(args, "SP", TYPE_CLASSID(Locale), &u, &_u, &locale))
+        key = Py_BuildValue("(Ns)", PyUnicode_FromUnicodeString(u),
+                            locale->getName());
+    else if (!parseArgs(args, "Sn", &u, &_u, &id))
+        key = Py_BuildValue("(NO)", PyUnicode_FromUnicodeString(u),
+                            PyTuple_GET_ITEM(args, 1));
+    else
+        return PyErr_SetArgsError(type, "getInstance", args);
+
+    if (key == NULL)
+        return NULL;
+
+    PyObject *formatter = formatterCache.lookup(key);
+
+    if (formatter == NULL)
+    {
+        UErrorCode status = U_ZERO_ERROR;
+        UnlocalizedNumberFormatter unlocalized =
+            NumberFormatter::forSkeleton(*u, status);
+
+        if (U_FAILURE(status))
+        {
+            Py_DECREF(key);
+            return ICUException(status).reportError();
+        }
+
+        formatter = wrap_LocalizedNumberFormatter(
+            locale ? unlocalized.locale(*locale)
+                   : unlocalized.locale(Locale(id)));
+
+        if (formatter != NULL && formatterCache.insert(key, formatter) < 0)
+            Py_CLEAR(formatter);
+    }
+
+    Py_DECREF(key);
+
+    return formatter;
+}
+
+static PyObject *t_localizednumberformatter_getCacheInfo(PyTypeObject *type)
+{
+    return formatterCache.getInfo();
+}
+
+static PyObject *t_localizednumberformatter_setCacheSize(PyTypeObject *type,
+                                                         PyObject *arg)
+{
+    int capacity;
+
+    if (!parseArg(arg, "i", &capacity) && capacity >= 0)
+    {
+        formatterCache.setCapacity(capacity);
+        Py_RETURN_NONE;
+    }
+
+    return PyErr_SetArgsError(type, "setCacheSize", arg);
+}
+
+static PyObject *t_localizednumberformatter_clearCache(PyTypeObject *type)
+{
+    formatterCache.clear();
+    Py_RETURN_NONE;
+}
+
+#endif  // ICU >= 62
+
 /* Notation */
 
 static PyObject *t_notation_scientific(PyTypeObject *type, PyObject *args)
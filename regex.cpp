@@ -47,6 +47,9 @@ static PyObject *t_regexpattern_flags(t_regexpattern *self);
 static PyObject *t_regexpattern_split(t_regexpattern *self, PyObject *args);
 static PyObject *t_regexpattern_compile(PyTypeObject *type, PyObject *args);
 static PyObject *t_regexpattern_matches(PyTypeObject *type, PyObject *args);
+static PyObject *t_regexpattern_getCacheInfo(PyTypeObject *type);
+static PyObject *t_regexpattern_setCacheSize(PyTypeObject *type, PyObject *arg);
+static PyObject *t_regexpattern_clearCache(PyTypeObject *type);
 
 static PyObject *wrap_RegexPattern(RegexPattern *pattern, PyObject *re);
 static PyObject *wrap_RegexMatcher(RegexMatcher *matcher, PyObject *pattern,
@@ -59,6 +62,9 @@ static PyMethodDef t_regexpattern_methods[] = {
     DECLARE_METHOD(t_regexpattern, split, METH_VARARGS),
     DECLARE_METHOD(t_regexpattern, compile, METH_VARARGS | METH_CLASS),
     DECLARE_METHOD(t_regexpattern, matches, METH_VARARGS | METH_CLASS),
+    DECLARE_METHOD(t_regexpattern, getCacheInfo, METH_NOARGS | METH_CLASS),
+    DECLARE_METHOD(t_regexpattern, setCacheSize, METH_O | METH_CLASS),
+    DECLARE_METHOD(t_regexpattern, clearCache, METH_NOARGS | METH_CLASS),
     { NULL, NULL, 0, NULL }
 };
 
@@ -85,6 +91,7 @@ public:
 #if U_ICU_VERSION_HEX >= 0x04000000
     PyObject *callable;
 #endif
+    ObjectLock lock;
 };
 
 static int t_regexmatcher_init(t_regexmatcher *self,
@@ -119,6 +126,19 @@ static PyObject *t_regexmatcher_appendReplacement(t_regexmatcher *self,
                                                   PyObject *args);
 static PyObject *t_regexmatcher_appendTail(t_regexmatcher *self, PyObject *arg);
 static PyObject *t_regexmatcher_split(t_regexmatcher *self, PyObject *args);
+// an exception raised by the match callback takes precedence over the
+// U_REGEX_STOPPED_BY_CALLER error it causes
+static PyObject *reportFindError(UErrorCode status)
+{
+    if (PyErr_Occurred())
+        return NULL;
+
+    return ICUException(status).reportError();
+}
+
+static PyObject *t_regexmatcher_findall(t_regexmatcher *self, PyObject *args);
+static PyObject *t_regexmatcher_finditer(t_regexmatcher *self);
+static PyObject *t_regexmatcher_sub(t_regexmatcher *self, PyObject *args);
 #if U_ICU_VERSION_HEX >= 0x04000000
 static PyObject *t_regexmatcher_setTimeLimit(t_regexmatcher *self,
                                              PyObject *arg);
@@ -147,6 +167,9 @@ static PyMethodDef t_regexmatcher_methods[] = {
     DECLARE_METHOD(t_regexmatcher, appendReplacement, METH_VARARGS),
     DECLARE_METHOD(t_regexmatcher, appendTail, METH_O),
     DECLARE_METHOD(t_regexmatcher, split, METH_VARARGS),
+    DECLARE_METHOD(t_regexmatcher, findall, METH_VARARGS),
+    DECLARE_METHOD(t_regexmatcher, finditer, METH_NOARGS),
+    DECLARE_METHOD(t_regexmatcher, sub, METH_VARARGS),
 #if U_ICU_VERSION_HEX >= 0x04000000
     DECLARE_METHOD(t_regexmatcher, region, METH_VARARGS),
     DECLARE_METHOD(t_regexmatcher, regionStart, METH_NOARGS),
@@ -179,6 +202,7 @@ static void t_regexmatcher_dealloc(t_regexmatcher *self)
 #if U_ICU_VERSION_HEX >= 0x04000000
     Py_CLEAR(self->callable);
 #endif
+    self->lock.free();
 
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
@@ -241,6 +265,31 @@ static PyObject *t_regexpattern_matcher(t_regexpattern *self, PyObject *args)
         STATUS_CALL(matcher = self->object->matcher(status));
         return wrap_RegexMatcher(matcher, (PyObject *) self, input);
       case 1:
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION) && \
+    U_ICU_VERSION_HEX >= 0x04060000
+        input = PyTuple_GET_ITEM(args, 0);
+        if (isBMPText(input))
+        {
+            UText ut = UTEXT_INITIALIZER;
+            UErrorCode status = U_ZERO_ERROR;
+
+            openPythonText(&ut, input, status);
+            matcher = self->object->matcher(status);
+            if (U_SUCCESS(status))
+                matcher->reset(&ut);  /* cloned, str not ref'd */
+            utext_close(&ut);
+
+            if (U_FAILURE(status))
+            {
+                delete matcher;
+                return ICUException(status).reportError();
+            }
+
+            Py_INCREF(input);
+            return wrap_RegexMatcher(matcher, (PyObject *) self, input);
+        }
+        input = NULL;
+#endif
         if (!parseArgs(args, "W", &u, &input))
         {
             UErrorCode status = U_ZERO_ERROR;
@@ -284,8 +333,9 @@ static PyObject *t_regexpattern_split(t_regexpattern *self, PyObject *args)
             UnicodeString array[31];
             PyObject *tuple;
 
-            STATUS_CALL(count = self->object->split(*u, array, capacity,
-                                                    status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                count = self->object->split(*u, array, capacity, status));
             tuple = PyTuple_New(count);
             for (int i = 0; i < count; i++)
                 PyTuple_SET_ITEM(tuple, i,
@@ -311,8 +361,10 @@ static PyObject *t_regexpattern_split(t_regexpattern *self, PyObject *args)
             if (!finally.array)
                 return PyErr_NoMemory();
 
-            STATUS_CALL(count = self->object->split(*u, finally.array,
-                                                    capacity, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                count = self->object->split(*u, finally.array, capacity,
+                                            status));
             tuple = PyTuple_New(count);
             for (int i = 0; i < count; i++)
                 PyTuple_SET_ITEM(tuple, i, PyUnicode_FromUnicodeString(&finally.array[i]));
@@ -324,43 +376,74 @@ static PyObject *t_regexpattern_split(t_regexpattern *self, PyObject *args)
     return PyErr_SetArgsError((PyObject *) self, "split", args);
 }
 
+/* Patterns compiled from a str, by (str, flags). Compiled patterns are not
+ * modified once built and may be shared by any number of matchers.
+ */
+static LRUCache patternCache(64);
+
+static PyObject *compile(PyTypeObject *type, PyObject *args,
+                         UnicodeString *u, PyObject *re, uint32_t flags)
+{
+    PyObject *key = NULL;
+
+    if (PyUnicode_Check(PyTuple_GET_ITEM(args, 0)))
+    {
+        key = Py_BuildValue("(OI)", PyTuple_GET_ITEM(args, 0),
+                            (unsigned int) flags);
+        if (key == NULL)
+        {
+            Py_XDECREF(re);
+            return NULL;
+        }
+
+        PyObject *pattern = patternCache.lookup(key);
+
+        if (pattern != NULL)
+        {
+            Py_DECREF(key);
+            Py_XDECREF(re);
+            return pattern;
+        }
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    UParseError parseError;
+    RegexPattern *pattern = RegexPattern::compile(*u, flags, parseError,
+                                                  status);
+
+    if (U_FAILURE(status))
+    {
+        Py_XDECREF(key);
+        Py_XDECREF(re);
+        return ICUException(parseError, status).reportError();
+    }
+
+    PyObject *result = wrap_RegexPattern(pattern, re);
+
+    if (key != NULL)
+    {
+        if (result != NULL && patternCache.insert(key, result) < 0)
+            Py_CLEAR(result);
+        Py_DECREF(key);
+    }
+
+    return result;
+}
+
 static PyObject *t_regexpattern_compile(PyTypeObject *type, PyObject *args)
 {
     UnicodeString *u;
     uint32_t flags;
-    RegexPattern *pattern;
     PyObject *re = NULL;
 
     switch (PyTuple_Size(args)) {
       case 1:
         if (!parseArgs(args, "W", &u, &re))
-        {
-            UErrorCode status = U_ZERO_ERROR;
-            UParseError parseError;
-
-            pattern = RegexPattern::compile(*u, parseError, status);
-            if (U_FAILURE(status))
-            {
-                Py_XDECREF(re);
-                return ICUException(parseError, status).reportError();
-            }
-            return wrap_RegexPattern(pattern, re);
-        }
+            return compile(type, args, u, re, 0);
         break;
       case 2:
         if (!parseArgs(args, "Wi", &u, &re, &flags))
-        {
-            UErrorCode status = U_ZERO_ERROR;
-            UParseError parseError;
-
-            pattern = RegexPattern::compile(*u, flags, parseError, status);
-            if (U_FAILURE(status))
-            {
-                Py_XDECREF(re);
-                return ICUException(parseError, status).reportError();
-            }
-            return wrap_RegexPattern(pattern, re);
-        }
+            return compile(type, args, u, re, flags);
         break;
     }
 
@@ -387,6 +470,31 @@ static PyObject *t_regexpattern_matches(PyTypeObject *type, PyObject *args)
     return PyErr_SetArgsError(type, "matches", args);
 }
 
+static PyObject *t_regexpattern_getCacheInfo(PyTypeObject *type)
+{
+    return patternCache.getInfo();
+}
+
+static PyObject *t_regexpattern_setCacheSize(PyTypeObject *type,
+                                             PyObject *arg)
+{
+    int capacity;
+
+    if (!parseArg(arg, "i", &capacity) && capacity >= 0)
+    {
+        patternCache.setCapacity(capacity);
+        Py_RETURN_NONE;
+    }
+
+    return PyErr_SetArgsError(type, "setCacheSize", arg);
+}
+
+static PyObject *t_regexpattern_clearCache(PyTypeObject *type)
+{
+    patternCache.clear();
+    Py_RETURN_NONE;
+}
+
 static PyObject *t_regexpattern_str(t_regexpattern *self)
 {
     UnicodeString u = self->object->pattern();
@@ -456,19 +564,41 @@ static PyObject *wrap_RegexMatcher(RegexMatcher *matcher, PyObject *pattern,
     return (PyObject *) self;
 }
 
+static inline int allowThreads(t_regexmatcher *self)
+{
+    // the matcher reads a wrapped UnicodeString input in place, keep the
+    // GIL if some other reference to it could be used to modify it
+    if (self->input != NULL && !PyUnicode_Check(self->input) &&
+        Py_REFCNT(self->input) > 1)
+        return 0;
+
+#if U_ICU_VERSION_HEX >= 0x04060000
+    // input() would make a UnicodeString copy of a str read in place
+    return allowThreads(
+        (int32_t) utext_nativeLength(self->object->inputText()));
+#else
+    return allowThreads(self->object->input().length());
+#endif
+}
+
 static PyObject *t_regexmatcher_matches(t_regexmatcher *self, PyObject *args)
 {
     int32_t startIndex;
     UBool b;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 0:
-        STATUS_CALL(b = self->object->matches(status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self),
+            b = self->object->matches(status));
         Py_RETURN_BOOL(b);
       case 1:
         if (!parseArgs(args, "i", &startIndex))
         {
-            STATUS_CALL(b = self->object->matches(startIndex, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(self),
+                b = self->object->matches(startIndex, status));
             Py_RETURN_BOOL(b);
         }
     }
@@ -480,15 +610,20 @@ static PyObject *t_regexmatcher_lookingAt(t_regexmatcher *self, PyObject *args)
 {
     int32_t startIndex;
     UBool b;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 0:
-        STATUS_CALL(b = self->object->lookingAt(status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self),
+            b = self->object->lookingAt(status));
         Py_RETURN_BOOL(b);
       case 1:
         if (!parseArgs(args, "i", &startIndex))
         {
-            STATUS_CALL(b = self->object->lookingAt(startIndex, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(self),
+                b = self->object->lookingAt(startIndex, status));
             Py_RETURN_BOOL(b);
         }
     }
@@ -500,15 +635,18 @@ static PyObject *t_regexmatcher_find(t_regexmatcher *self, PyObject *args)
 {
     int32_t startIndex;
     UBool b;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 0:
-        b = self->object->find();
+        ALLOW_THREADS_CALL(allowThreads(self), b = self->object->find());
         Py_RETURN_BOOL(b);
       case 1:
         if (!parseArgs(args, "i", &startIndex))
         {
-            STATUS_CALL(b = self->object->find(startIndex, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(self),
+                b = self->object->find(startIndex, status));
             Py_RETURN_BOOL(b);
         }
     }
@@ -526,6 +664,7 @@ static PyObject *t_regexmatcher_group(t_regexmatcher *self, PyObject *args)
 {
     UnicodeString u;
     int32_t groupNum;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 0:
@@ -592,7 +731,9 @@ static PyObject *t_regexmatcher_end(t_regexmatcher *self, PyObject *args)
 static PyObject *t_regexmatcher_reset(t_regexmatcher *self, PyObject *args)
 {
     int32_t index;
-    UnicodeString *u, _u;
+    UnicodeString *u;
+    PyObject *input;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 0:
@@ -604,7 +745,29 @@ static PyObject *t_regexmatcher_reset(t_regexmatcher *self, PyObject *args)
             STATUS_CALL(self->object->reset(index, status));
             Py_RETURN_SELF();
         }
-        if (!parseArgs(args, "S", &u, &_u))
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION) && \
+    U_ICU_VERSION_HEX >= 0x04060000
+        input = PyTuple_GET_ITEM(args, 0);
+        if (isBMPText(input))
+        {
+            UText ut = UTEXT_INITIALIZER;
+            UErrorCode status = U_ZERO_ERROR;
+
+            openPythonText(&ut, input, status);
+            self->object->reset(&ut);  /* cloned, str not ref'd */
+            utext_close(&ut);
+
+            if (U_FAILURE(status))
+                return ICUException(status).reportError();
+
+            Py_INCREF(input);
+            Py_XDECREF(self->input);
+            self->input = input;
+            Py_RETURN_SELF();
+        }
+#endif
+        // the matcher refers to the input string, it must be saved
+        if (!parseArgs(args, "W", &u, &self->input))
         {
             self->object->reset(*u);
             Py_RETURN_SELF();
@@ -617,6 +780,12 @@ static PyObject *t_regexmatcher_reset(t_regexmatcher *self, PyObject *args)
 
 static PyObject *t_regexmatcher_input(t_regexmatcher *self)
 {
+    if (self->input != NULL && PyUnicode_Check(self->input))
+    {
+        Py_INCREF(self->input);
+        return self->input;
+    }
+
     UnicodeString u = self->object->input();
     return PyUnicode_FromUnicodeString(&u);
 }
@@ -626,6 +795,7 @@ static PyObject *t_regexmatcher_input(t_regexmatcher *self)
 static PyObject *t_regexmatcher_region(t_regexmatcher *self, PyObject *args)
 {
     int32_t start, end;
+    ObjectLocker locker(self->lock);
 
     if (!parseArgs(args, "ii", &start, &end))
     {
@@ -658,6 +828,7 @@ static PyObject *t_regexmatcher_useTransparentBounds(t_regexmatcher *self,
                                                      PyObject *arg)
 {
     UBool b;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "B", &b))
     {
@@ -678,6 +849,7 @@ static PyObject *t_regexmatcher_useAnchoringBounds(t_regexmatcher *self,
                                                    PyObject *arg)
 {
     UBool b;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "B", &b))
     {
@@ -705,10 +877,13 @@ static PyObject *t_regexmatcher_requireEnd(t_regexmatcher *self)
 static PyObject *t_regexmatcher_replaceAll(t_regexmatcher *self, PyObject *arg)
 {
     UnicodeString *u, _u, result;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "S", &u, &_u))
     {
-        STATUS_CALL(result = self->object->replaceAll(*u, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self) && u == &_u,
+            result = self->object->replaceAll(*u, status));
         return PyUnicode_FromUnicodeString(&result);
     }
 
@@ -719,10 +894,13 @@ static PyObject *t_regexmatcher_replaceFirst(t_regexmatcher *self,
                                              PyObject *arg)
 {
     UnicodeString *u, _u, result;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "S", &u, &_u))
     {
-        STATUS_CALL(result = self->object->replaceFirst(*u, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self) && u == &_u,
+            result = self->object->replaceFirst(*u, status));
         return PyUnicode_FromUnicodeString(&result);
     }
 
@@ -734,6 +912,7 @@ static PyObject *t_regexmatcher_appendReplacement(t_regexmatcher *self,
 {
     UnicodeString *u0, _u0;
     UnicodeString *u1, _u1;
+    ObjectLocker locker(self->lock);
 
     if (!parseArgs(args, "SS", &u0, &_u0, &u1, &_u1))
     {
@@ -747,6 +926,7 @@ static PyObject *t_regexmatcher_appendReplacement(t_regexmatcher *self,
 static PyObject *t_regexmatcher_appendTail(t_regexmatcher *self, PyObject *arg)
 {
     UnicodeString *u, _u, result;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "S", &u, &_u))
     {
@@ -761,6 +941,7 @@ static PyObject *t_regexmatcher_split(t_regexmatcher *self, PyObject *args)
 {
     UnicodeString *u, _u;
     int capacity, count;
+    ObjectLocker locker(self->lock);
 
     if (!parseArgs(args, "Si", &u, &_u, &capacity))
     {
@@ -769,8 +950,9 @@ static PyObject *t_regexmatcher_split(t_regexmatcher *self, PyObject *args)
             UnicodeString array[31];
             PyObject *tuple;
 
-            STATUS_CALL(count = self->object->split(*u, array, capacity,
-                                                    status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                count = self->object->split(*u, array, capacity, status));
             tuple = PyTuple_New(count);
             for (int i = 0; i < count; i++)
                 PyTuple_SET_ITEM(tuple, i,
@@ -796,8 +978,10 @@ static PyObject *t_regexmatcher_split(t_regexmatcher *self, PyObject *args)
             if (!finally.array)
                 return PyErr_NoMemory();
 
-            STATUS_CALL(count = self->object->split(*u, finally.array,
-                                                    capacity, status));
+            STATUS_ALLOW_THREADS_CALL(
+                allowThreads(u, &_u),
+                count = self->object->split(*u, finally.array, capacity,
+                                            status));
             tuple = PyTuple_New(count);
             for (int i = 0; i < count; i++)
                 PyTuple_SET_ITEM(tuple, i, PyUnicode_FromUnicodeString(&finally.array[i]));
@@ -809,12 +993,370 @@ static PyObject *t_regexmatcher_split(t_regexmatcher *self, PyObject *args)
     return PyErr_SetArgsError((PyObject *) self, "split", args);
 }
 
+static inline UBool findNext(RegexMatcher *matcher, UErrorCode &status)
+{
+#if U_ICU_VERSION_HEX >= VERSION_HEX(55, 0, 0)
+    return matcher->find(status);  // honors the time limit and callback
+#else
+    return matcher->find();
+#endif
+}
+
+/* Converts UTF-16 offsets into a string, mostly increasing, to code point
+ * offsets by counting code points from the previous offset converted.
+ */
+class codePointCounter {
+private:
+    const UChar *chars;
+    int32_t unit, cp;
+
+public:
+    explicit codePointCounter(const UnicodeString &u) :
+        chars(u.getBuffer()), unit(0), cp(0) {}
+
+    int32_t operator()(int32_t offset)
+    {
+        if (offset < 0)  // unmatched group
+            return offset;
+
+        if (offset >= unit)
+            cp += u_countChar32(chars + unit, offset - unit);
+        else
+            cp -= u_countChar32(chars + offset, unit - offset);
+        unit = offset;
+
+        return cp;
+    }
+};
+
+/* Finds every match in the input of matcher, after resetting it, and
+ * collects the code point offsets of the start and end of the groups first
+ * to first + groups - 1 of each match. Returns a malloc'ed array of
+ * 2 * groups * count offsets.
+ */
+static int32_t *findSpans(RegexMatcher *matcher, int32_t first, int32_t groups,
+                          int32_t &count, UErrorCode &status)
+{
+    int32_t capacity = 64, size = 0;
+    int32_t *spans = (int32_t *) malloc(capacity * sizeof(int32_t));
+
+    count = 0;
+    if (spans == NULL)
+    {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return NULL;
+    }
+
+    matcher->reset();
+    while (findNext(matcher, status))
+    {
+        if (size + groups * 2 > capacity)
+        {
+            while (size + groups * 2 > capacity)
+                capacity *= 2;
+
+            int32_t *larger = (int32_t *) realloc(
+                spans, capacity * sizeof(int32_t));
+
+            if (larger == NULL)
+            {
+                status = U_MEMORY_ALLOCATION_ERROR;
+                break;
+            }
+            spans = larger;
+        }
+
+        for (int32_t group = first; group < first + groups; ++group)
+        {
+            spans[size++] = matcher->start(group, status);
+            spans[size++] = matcher->end(group, status);
+        }
+
+        if (U_FAILURE(status))
+            break;
+    }
+
+    if (U_FAILURE(status))
+    {
+        free(spans);
+        return NULL;
+    }
+
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION) && \
+    U_ICU_VERSION_HEX >= 0x04060000
+    // a str read in place is indexed by code point already
+    if (!isPythonText(matcher->inputText()))
+#endif
+    {
+        codePointCounter counter(matcher->input());
+
+        for (int32_t i = 0; i < size; ++i)
+            spans[i] = counter(spans[i]);
+    }
+    count = size / (groups * 2);
+
+    return spans;
+}
+
+static PyObject *t_regexmatcher_findall(t_regexmatcher *self, PyObject *args)
+{
+    int32_t group = 0, count;
+    ObjectLocker locker(self->lock);
+
+    switch (PyTuple_Size(args)) {
+      case 0:
+        break;
+      case 1:
+        if (!parseArgs(args, "i", &group))
+            break;
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "findall", args);
+    }
+
+    if (group < 0 || group > self->object->groupCount())
+        return ICUException(U_INDEX_OUTOFBOUNDS_ERROR).reportError();
+
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t *spans;
+
+    ALLOW_THREADS_CALL(
+        allowThreads(self),
+        spans = findSpans(self->object, group, 1, count, status));
+    if (spans == NULL)
+        return reportFindError(status);
+
+    PyObject *result = PyByteArray_FromStringAndSize(
+        (const char *) spans, count * 2 * sizeof(int32_t));
+
+    free(spans);
+
+    return toInt32View(result);
+}
+
+static PyObject *t_regexmatcher_finditer(t_regexmatcher *self)
+{
+    int32_t groups = self->object->groupCount() + 1, count;
+    int32_t *spans;
+    UErrorCode status = U_ZERO_ERROR;
+    ObjectLocker locker(self->lock);
+
+    ALLOW_THREADS_CALL(
+        allowThreads(self),
+        spans = findSpans(self->object, 0, groups, count, status));
+    if (spans == NULL)
+        return reportFindError(status);
+
+    PyObject *matches = PyList_New(count);
+
+    for (int32_t i = 0; matches != NULL && i < count; ++i)
+    {
+        PyObject *match = PyTuple_New(groups);
+        int32_t *span = spans + i * groups * 2;
+
+        for (int32_t group = 0; match != NULL && group < groups; ++group)
+        {
+            PyObject *pair = Py_BuildValue("(ii)", span[group * 2],
+                                           span[group * 2 + 1]);
+
+            if (pair == NULL)
+                Py_CLEAR(match);
+            else
+                PyTuple_SET_ITEM(match, group, pair);
+        }
+
+        if (match == NULL)
+            Py_CLEAR(matches);
+        else
+            PyList_SET_ITEM(matches, i, match);
+    }
+    free(spans);
+
+    if (matches == NULL)
+        return NULL;
+
+    PyObject *result = PyObject_GetIter(matches);
+    Py_DECREF(matches);
+
+    return result;
+}
+
+static void substitute(RegexMatcher *matcher, const UnicodeString &replacement,
+                       int32_t count, UnicodeString &result,
+                       UErrorCode &status)
+{
+    matcher->reset();
+    for (int32_t n = 0; (count == 0 || n < count) && findNext(matcher, status);
+         ++n)
+    {
+        matcher->appendReplacement(result, replacement, status);
+        if (U_FAILURE(status))
+            return;
+    }
+
+    if (U_SUCCESS(status))
+        matcher->appendTail(result);
+}
+
+// appends the input of matcher between the native start and limit indexes
+static void appendInput(RegexMatcher *matcher, int64_t start, int64_t limit,
+                        UnicodeString &result)
+{
+#if U_ICU_VERSION_HEX >= 0x04060000
+    UText *input = matcher->inputText();
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t length = utext_extract(input, start, limit, NULL, 0, &status);
+    int32_t size = result.length();
+    UChar *chars = result.getBuffer(size + length);
+
+    if (chars != NULL)
+    {
+        status = U_ZERO_ERROR;
+        utext_extract(input, start, limit, chars + size, length, &status);
+        result.releaseBuffer(size + length);
+    }
+#else
+    const UnicodeString &input = matcher->input();
+
+    result.append(input, (int32_t) start, (int32_t) (limit - start));
+#endif
+}
+
+// the callable is passed the matcher, it may not reset or move it
+static bool isMatchAt(t_regexmatcher *self, PyObject *input,
+                      int32_t start, int32_t end)
+{
+    UErrorCode status = U_ZERO_ERROR;
+
+    return (self->input == input &&
+            self->object->start(status) == start &&
+            self->object->end(status) == end && U_SUCCESS(status));
+}
+
+static int substitute(t_regexmatcher *self, PyObject *callable, int32_t count,
+                      UnicodeString &result)
+{
+    RegexMatcher *matcher = self->object;
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t last = 0;
+    int error = 0;
+
+    // kept alive so that a new input can't be mistaken for it
+    PyObject *input = self->input;
+    Py_XINCREF(input);
+
+    matcher->reset();
+    for (int32_t n = 0; (count == 0 || n < count) && findNext(matcher, status);
+         ++n)
+    {
+        int32_t start = matcher->start(status);
+        int32_t end = matcher->end(status);
+        PyObject *replacement =
+            PyObject_CallFunctionObjArgs(callable, (PyObject *) self, NULL);
+        UnicodeString *u, _u;
+
+        if (replacement == NULL)
+        {
+            error = -1;
+            break;
+        }
+
+        if (!isMatchAt(self, input, start, end))
+        {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "matcher reset or moved during sub()");
+            Py_DECREF(replacement);
+            error = -1;
+            break;
+        }
+
+        if (parseArg(replacement, "S", &u, &_u))
+        {
+            PyErr_SetObject(PyExc_TypeError, replacement);
+            Py_DECREF(replacement);
+            error = -1;
+            break;
+        }
+
+        appendInput(matcher, last, start, result);
+        result.append(*u);
+        Py_DECREF(replacement);
+
+        last = end;
+    }
+    Py_XDECREF(input);
+
+    if (error < 0)
+        return -1;
+
+    if (U_FAILURE(status))
+    {
+        reportFindError(status);
+        return -1;
+    }
+
+    appendInput(matcher, last, INT32_MAX, result);
+
+    return 0;
+}
+
+static PyObject *t_regexmatcher_sub(t_regexmatcher *self, PyObject *args)
+{
+    UnicodeString *u, _u, result;
+    PyObject *callable;
+    int count = 0;
+    ObjectLocker locker(self->lock);
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "S", &u, &_u))
+        {
+            UErrorCode status = U_ZERO_ERROR;
+
+            ALLOW_THREADS_CALL(
+                allowThreads(self) && u == &_u,
+                substitute(self->object, *u, 0, result, status));
+            if (U_FAILURE(status))
+                return reportFindError(status);
+            return PyUnicode_FromUnicodeString(&result);
+        }
+        if (!parseArgs(args, "M", &callable))
+        {
+            if (substitute(self, callable, 0, result) < 0)
+                return NULL;
+            return PyUnicode_FromUnicodeString(&result);
+        }
+        break;
+      case 2:
+        if (!parseArgs(args, "Si", &u, &_u, &count) && count >= 0)
+        {
+            UErrorCode status = U_ZERO_ERROR;
+
+            ALLOW_THREADS_CALL(
+                allowThreads(self) && u == &_u,
+                substitute(self->object, *u, count, result, status));
+            if (U_FAILURE(status))
+                return reportFindError(status);
+            return PyUnicode_FromUnicodeString(&result);
+        }
+        if (!parseArgs(args, "Mi", &callable, &count) && count >= 0)
+        {
+            if (substitute(self, callable, count, result) < 0)
+                return NULL;
+            return PyUnicode_FromUnicodeString(&result);
+        }
+        break;
+    }
+
+    return PyErr_SetArgsError((PyObject *) self, "sub", args);
+}
+
 #if U_ICU_VERSION_HEX >= 0x04000000
 
 static PyObject *t_regexmatcher_setTimeLimit(t_regexmatcher *self,
                                              PyObject *arg)
 {
     int32_t limit;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "i", &limit))
     {
@@ -835,6 +1377,7 @@ static PyObject *t_regexmatcher_setStackLimit(t_regexmatcher *self,
                                              PyObject *arg)
 {
     int32_t limit;
+    ObjectLocker locker(self->lock);
 
     if (!parseArg(arg, "i", &limit))
     {
@@ -854,6 +1397,8 @@ static PyObject *t_regexmatcher_getStackLimit(t_regexmatcher *self)
 static UBool t_regexmatcher_matchCallback(const void *context, int32_t steps)
 {
     t_regexmatcher *self = (t_regexmatcher *) context;
+    // called with the GIL released when matching long enough input
+    PyGILState_STATE state = PyGILState_Ensure();
     PyObject *n = PyInt_FromLong(steps);
     PyObject *args = PyTuple_Pack(1, n);
     PyObject *result = PyObject_Call(self->callable, args, NULL);
@@ -861,14 +1406,18 @@ static UBool t_regexmatcher_matchCallback(const void *context, int32_t steps)
 
     Py_DECREF(args);
     Py_DECREF(n);
-    
+
     if (!result)
-        return 0;
+        b = 0;
+    else
+    {
+        b = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (b == -1)
+            b = 0;
+    }
 
-    b = PyObject_IsTrue(result);
-    Py_DECREF(result);
-    if (b == -1)
-        return 0;
+    PyGILState_Release(state);
 
     return b;
 }
@@ -876,6 +1425,8 @@ static UBool t_regexmatcher_matchCallback(const void *context, int32_t steps)
 static PyObject *t_regexmatcher_setMatchCallback(t_regexmatcher *self,
                                                  PyObject *arg)
 {
+    ObjectLocker locker(self->lock);
+
     if (PyCallable_Check(arg))
     {
         Py_INCREF(arg);
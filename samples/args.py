@@ -0,0 +1,63 @@
+# ====================================================================
+# Copyright (c) 2021 Open Source Applications Foundation.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+# ====================================================================
+#
+
+# Measures the per-call overhead of some common methods, which is dominated
+# by argument parsing for short arguments. Overloaded methods, such as
+# NumberFormat.format(), try each of their signatures in turn and wrapped
+# ICU objects, such as the GregorianCalendar passed to DateFormat.format(),
+# are type checked against the class declared by the signature.
+
+from timeit import repeat
+from icu import \
+    Collator, Normalizer2, NumberFormat, DateFormat, Calendar, Locale, \
+    FieldPosition, UnicodeString
+
+
+def measure(name, fn, number=1000000):
+
+    best = min(repeat(fn, number=number, repeat=3))
+    print("%-40s %6.0f ns/call" %(name, best * 1e9 / number))
+
+
+if __name__ == "__main__":
+    locale = Locale.getUS()
+    collator = Collator.createInstance(locale)
+    normalizer = Normalizer2.getNFCInstance()
+    numberFormat = NumberFormat.createInstance(locale)
+    dateFormat = DateFormat.createDateInstance(DateFormat.kShort, locale)
+    calendar = Calendar.createInstance(locale)
+    fieldPosition = FieldPosition()
+    u = UnicodeString(u"abc")
+
+    measure("Collator.compare(str, str)",
+            lambda: collator.compare(u"abc", u"abd"))
+    measure("Collator.compare(UnicodeString, str)",
+            lambda: collator.compare(u, u"abd"))
+    measure("Normalizer2.normalize(str)",
+            lambda: normalizer.normalize(u"abc"))
+    measure("NumberFormat.format(float)",
+            lambda: numberFormat.format(1.5))
+    measure("NumberFormat.format(float, FieldPosition)",
+            lambda: numberFormat.format(1.5, fieldPosition))
+    measure("DateFormat.format(GregorianCalendar)",
+            lambda: dateFormat.format(calendar))
@@ -0,0 +1,59 @@
+# ====================================================================
+# Copyright (c) 2021 Open Source Applications Foundation.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+# ====================================================================
+#
+
+# Measures the throughput of converting python strings to and from ICU
+# UnicodeString objects, for each of python's internal string kinds. Latin-1
+# and astral strings are converted by copying, BMP strings are aliased on
+# the way in.
+
+import sys
+
+from timeit import repeat
+from icu import UnicodeString
+
+samples = [
+    ("ascii", u"The quick brown fox jumps over the lazy dog. "),
+    ("latin-1", u"Les na\xeffs \xe6githales h\xe2tifs pond\xe9rant \xe0 No\xebl. "),
+    ("bmp", u"Съешь же ещё этих мягких пулок. "),
+    ("astral", u"\U0001f600 smile \U0001d54f math \U00020000 cjk. "),
+]
+
+
+def measure(name, direction, fn, size, number):
+
+    best = min(repeat(fn, number=number, repeat=5))
+    print("%-8s %-6s %10.0f MB/s" %(name, direction,
+                                   size * number / best / 1e6))
+
+
+if __name__ == "__main__":
+    length = int(sys.argv[1]) if len(sys.argv) > 1 else 65536
+    number = max(10, 50000000 // length)
+
+    for name, text in samples:
+        text = (text * (length // len(text) + 1))[:length]
+        string = UnicodeString(text)
+        size = len(string) * 2
+
+        measure(name, "to", lambda: UnicodeString(text), size, number)
+        measure(name, "from", lambda: str(string), size, number)
@@ -0,0 +1,59 @@
+# ====================================================================
+# Copyright (c) 2021 Open Source Applications Foundation.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+# ====================================================================
+#
+
+# Measures the cost of converting python dates to ICU UDate values, as done
+# by every API taking a date, such as DateFormat.format() or
+# Calendar.setTime(). Naive datetimes and datetimes with an ICUtzinfo are
+# converted without calling into python, datetimes with any other tzinfo
+# still call their utcoffset() method.
+
+from timeit import repeat
+from datetime import datetime, timedelta, tzinfo
+from icu import Calendar, ICUtzinfo
+
+
+class FixedOffset(tzinfo):
+
+    def utcoffset(self, dt):
+        return timedelta(hours=-5)
+
+    def dst(self, dt):
+        return timedelta(0)
+
+
+def measure(name, value, number=1000000):
+
+    setTime = Calendar.createInstance().setTime
+    best = min(repeat(lambda: setTime(value), number=number, repeat=3))
+    print("%-20s %6.0f ns/call" %(name, best * 1e9 / number))
+
+
+if __name__ == "__main__":
+    dt = datetime(2006, 4, 18, 5, 12)
+
+    measure("float", 1145337120.0)
+    measure("naive datetime", dt)
+    measure("ICUtzinfo", dt.replace(
+        tzinfo=ICUtzinfo.getInstance('America/New_York')))
+    measure("FloatingTZ", dt.replace(tzinfo=ICUtzinfo.getFloating()))
+    measure("python tzinfo", dt.replace(tzinfo=FixedOffset()))
@@ -29,9 +29,9 @@ from icu import *
 
 class TestBreakIterator(TestCase):
 
-    def assertIsInstance(self, obj, cls):
+    def assertIsInstance(self, obj, cls, msg=None):
         if hasattr(TestCase, 'assertIsInstance'):
-            TestCase.assertIsInstance(self, obj, cls)
+            TestCase.assertIsInstance(self, obj, cls, msg)
         else:
             self.assertTrue(isinstance(obj, cls),
                             u'%s is not an instance of %s' % (obj, cls))
@@ -59,6 +59,130 @@ class TestBreakIterator(TestCase):
             rbi = RuleBasedBreakIterator(data)
             self.assertEqual(data, rbi.getBinaryRules())
 
+    def testBoundaries(self):
+
+        text = u"Hello, w\u00f6rld! \U0001f600 smile. " * 50
+        bi = BreakIterator.createWordInstance(Locale.getEnglish())
+        self.assertEqual(list(bi.boundaries()), [0])
+
+        bi.setText(text)
+        bi.following(10)
+        current = bi.current()
+
+        offsets = [bi.first()] + list(bi)
+        bi.following(10)
+
+        boundaries = bi.boundaries()
+        self.assertEqual(boundaries.format, 'i')
+        self.assertEqual(list(boundaries), offsets)
+        self.assertEqual(bi.current(), current)
+
+        if ICU_VERSION >= '52.0':
+            statuses = []
+            bi.first()
+            for offset in bi:
+                statuses.append(bi.getRuleStatus())
+            boundaries, ruleStatuses = bi.boundaries(True)
+            self.assertEqual(list(boundaries), offsets)
+            self.assertEqual(list(ruleStatuses)[1:], statuses)
+
+        u = UnicodeString(text)
+        boundaries = bi.boundaries(False, True)
+        self.assertEqual(list(boundaries),
+                         [len(str(u[:offset])) for offset in offsets])
+        self.assertEqual(boundaries[-1], len(text))
+
+        # long enough for the GIL to be released
+        bi.setText(text * 20)
+        self.assertEqual(len(bi.boundaries()), len(offsets) * 20 - 19)
+
+    def testSetTextStr(self):
+
+        bi = BreakIterator.createWordInstance(Locale.getEnglish())
+        for text in (u"caf\u00e9, au lait. " * 100,
+                     u"\u0100bc, d\u0101e\u4e2d. " * 100):
+            bi.setText(UnicodeString(text))
+            expected = list(bi)
+
+            bi.setText(text)
+            self.assertEqual(list(bi), expected)
+            self.assertEqual(list(bi.boundaries(False, True))[1:], expected)
+            self.assertEqual(bi.preceding(len(text)), expected[-2])
+
+            chars = bi.getText()
+            self.assertEqual(chars.first(), ord(text[0]))
+            self.assertEqual(chars.endIndex(), len(text))
+
+    def testTokenize(self):
+
+        if ICU_VERSION < '52.0':
+            return
+
+        text = u"Hello, w\u00f6rld! \U0001f600 42 times."
+        words = [u'Hello', u'w\u00f6rld', u'42', u'times']
+        locale = Locale.getEnglish()
+
+        self.assertEqual(BreakIterator.tokenize(text, locale), words)
+        self.assertEqual(BreakIterator.tokenize(text, locale, None), words)
+        self.assertEqual(BreakIterator.tokenize(UnicodeString(text), locale),
+                         words)
+        self.assertEqual(BreakIterator.tokenize(text, locale,
+                                                [UWordBreak.NUMBER]),
+                         [u'42'])
+
+        spans = BreakIterator.tokenize(text, locale, None, True)
+        self.assertEqual([word for word, start, end in spans], words)
+        for word, start, end in spans:
+            self.assertEqual(text[start:end], word)
+
+        # every segment, as found by a word BreakIterator
+        spans = BreakIterator.tokenize(
+            text * 100, locale,
+            [UWordBreak.NONE, UWordBreak.NUMBER, UWordBreak.LETTER,
+             UWordBreak.KANA, UWordBreak.IDEO], True)
+        self.assertEqual(u''.join(word for word, start, end in spans),
+                         text * 100)
+
+        bi = BreakIterator.createWordInstance(locale)
+        bi.setText(text * 100)
+        self.assertEqual([end for word, start, end in spans],
+                         list(bi.boundaries(False, True))[1:])
+
+        self.assertEqual(BreakIterator.tokenize(u'', locale), [])
+        self.assertRaises(InvalidArgsError, BreakIterator.tokenize, text)
+
+    def testTokenizeThreads(self):
+
+        if ICU_VERSION < '52.0':
+            return
+
+        import threading
+
+        locale = Locale.getEnglish()
+        # long enough to release the GIL
+        texts = [u'Hello, w\u00f6rld! ' * 200,
+                 u'42 times. ' * 300]
+        words = [BreakIterator.tokenize(text, locale) for text in texts]
+        errors = []
+
+        def tokenize(text, words):
+            try:
+                for i in range(200):
+                    if BreakIterator.tokenize(text, locale) != words:
+                        errors.append(i)
+            except Exception as e:
+                errors.append(e)
+
+        threads = [threading.Thread(target=tokenize, args=args)
+                   for args in zip(texts, words) for i in range(2)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join(60)
+            self.assertFalse(thread.is_alive())
+
+        self.assertEqual(errors, [])
+
 
 if __name__ == "__main__":
     main()
@@ -69,6 +69,76 @@ class TestBytesTrie(TestCase):
         trie.resetToState(state)
         self.assertEqual((2, 88), (trie.next('p'), trie.getValue()))
 
+    def testAddAll(self):
+
+        mappings = { 'ab': 3, 'abc': 6, 'abcd': 2, 'abcef': 11,
+                     'abcp': 88, 'abcqr': 20 }
+
+        trie = BytesTrie.Builder().addAll(mappings).build(
+            UStringTrieBuildOption.FAST)
+        self.assertEqual(mappings, dict(trie))
+
+        builder = BytesTrie.Builder()
+        builder.addAll(sorted(mappings.items()))
+        self.assertEqual(mappings, dict(builder.build(
+            UStringTrieBuildOption.SMALL)))
+
+        builder.addAll([(b'abc', 6), ('ab', 3)]).addAll(iter([['abcd', 2]]))
+        self.assertEqual({ 'ab': 3, 'abc': 6, 'abcd': 2 },
+                         dict(builder.build(UStringTrieBuildOption.FAST)))
+
+        self.assertRaises(TypeError, builder.addAll, [(1, 2)])
+        self.assertRaises(TypeError, builder.addAll, { 'a': 'b' })
+        self.assertRaises(ValueError, builder.addAll, [('a', 1, 2)])
+        self.assertRaises(OverflowError, builder.addAll, [('a', 1 << 40)])
+
+    def testSerialized(self):
+
+        mappings = { 'ab': 3, 'abc': 6, 'abcd': 2, 'abcef': 11,
+                     'abcp': 88, 'abcqr': 20 }
+
+        builder = BytesTrie.Builder()
+        for key, value in mappings.items():
+            builder.add(key, value)
+        data = builder.buildSerialized(UStringTrieBuildOption.SMALL)
+        self.assertTrue(isinstance(data, bytes))
+
+        trie = BytesTrie(data)
+        self.assertEqual(mappings, dict(trie))
+        self.assertEqual((3, 6), (trie.next('abc'), trie.getValue()))
+
+        # a writable buffer is copied
+        buffer = bytearray(data)
+        iterator = iter(BytesTrie(buffer))
+        buffer[:] = bytearray(len(buffer))
+        self.assertEqual(mappings, dict(iterator))
+
+        self.assertRaises(RuntimeError, trie.__init__, data)
+
+        self.assertRaises(ValueError, BytesTrie, b'')
+        self.assertRaises(InvalidArgsError, BytesTrie, u'abc')
+
+    def testMmap(self):
+
+        import mmap, tempfile
+
+        builder = BytesTrie.Builder()
+        for i in range(1000):
+            builder.add('key%d' % i, i)
+
+        with tempfile.TemporaryFile() as f:
+            f.write(builder.buildSerialized(UStringTrieBuildOption.FAST))
+            f.flush()
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+            trie = BytesTrie(data)
+            self.assertEqual((2, 567), (trie.next('key567'), trie.getValue()))
+
+            # the trie holds on to the mapping
+            self.assertRaises(BufferError, data.close)
+            del trie
+            data.close()
+
 
 if __name__ == "__main__":
     if ICU_VERSION >= '4.8':
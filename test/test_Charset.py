@@ -63,6 +63,221 @@ class TestCharset(TestCase):
 
         self.assertTrue(ustring.encode('iso-8859-1') == bytes)
 
+    def testBuffers(self):
+
+        text = u'beaut\xe9 probable'.encode('iso-8859-1')
+        data = bytearray(text)
+
+        for buffer in (data, memoryview(data)):
+            detector = CharsetDetector(buffer, 'iso-8859-1')
+            self.assertTrue("ISO-8859-1" in (m.getName()
+                                             for m in detector.detectAll()))
+            ustring = six.text_type(detector.detect())
+            self.assertTrue(ustring.encode('iso-8859-1') == text)
+
+        self.assertRaises(InvalidArgsError, CharsetDetector, u'foo')
+
+    def testMmap(self):
+
+        import mmap, tempfile
+
+        text = u'\u0441\u043b\u043e\u0432\u043e\n'.encode('utf-8') * 10000
+        with tempfile.TemporaryFile() as f:
+            f.write(text)
+            f.flush()
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            try:
+                detector = CharsetDetector(data)
+                self.assertEqual('UTF-8', detector.detect().getName())
+                del detector
+            finally:
+                data.close()
+
+    def testDetectSampled(self):
+
+        head = u'plain ascii text\n'.encode('ascii') * 1000
+        tail = u'beaut\xe9 \u0441\u043b\u043e\u0432\u043e\n'.encode('utf-8') * 1000
+        detector = CharsetDetector(head + tail)
+
+        matches = detector.detectSampled()
+        self.assertEqual('UTF-8', matches[0][0])
+        self.assertTrue(all(a[1] >= b[1]
+                            for a, b in zip(matches, matches[1:])))
+
+        # the head alone is plain ascii
+        matches = detector.detectSampled(1)
+        self.assertNotEqual('UTF-8', matches[0][0])
+
+        matches = detector.detectSampled(4, 1024)
+        self.assertEqual('UTF-8', matches[0][0])
+        self.assertTrue(matches[0][1] > matches[1][1])
+
+        # the whole text is set back
+        self.assertEqual((head + tail).decode('utf-8'),
+                         six.text_type(detector.detect()))
+        self.assertEqual((), CharsetDetector().detectSampled())
+        self.assertRaises(InvalidArgsError, detector.detectSampled, 0)
+
+
+class TestConverter(TestCase):
+
+    def testDecode(self):
+
+        converter = Converter('utf-8')
+        self.assertEqual('UTF-8', converter.getName())
+
+        # multibyte sequences split across chunks
+        text = u'h\xe9llo \u20ac\U0001f600'
+        data = text.encode('utf-8')
+        decoded = u''.join(converter.decode(data[i:i + 1])
+                           for i in range(len(data)))
+        self.assertEqual(text, decoded + converter.decode(b'', True))
+        self.assertEqual(text, converter.decode(bytearray(data), True))
+
+        self.assertRaises(UnicodeDecodeError, converter.decode,
+                          data[:-1], True)
+        try:
+            converter.decode(u'ab'.encode('ascii') + b'\xff', True)
+        except UnicodeDecodeError as e:
+            self.assertEqual((2, 3), (e.start, e.end))
+
+        converter.setErrors('ignore')
+        self.assertEqual(u'abcd', converter.decode(b'ab\xffcd', True))
+        converter.setErrors('replace')
+        self.assertEqual(u'ab\ufffdcd', converter.decode(b'ab\xffcd', True))
+        self.assertEqual('replace', converter.getErrors())
+
+        self.assertRaises(LookupError, Converter, 'utf-8', 'unknown')
+        self.assertRaises(ICUError, Converter, 'unknown')
+
+    def testEncode(self):
+
+        converter = Converter('cp037')
+        self.assertEqual(u'Hello'.encode('cp037'),
+                         converter.encode(u'Hello', True))
+        self.assertEqual(u'Hello'.encode('cp037'),
+                         converter.encode(UnicodeString(u'Hello'), True))
+
+        jis = Converter('ISO-2022-JP')
+        text = u'\u65e5\u672c\u8a9e abc'
+        data = jis.encode(text[:2]) + jis.encode(text[2:], True)
+        self.assertEqual(text, Converter('ISO-2022-JP').decode(data, True))
+
+        converter = Converter('iso-8859-1')
+        try:
+            converter.encode(u'a\U0001f600b\u20ac', True)
+        except UnicodeEncodeError as e:
+            self.assertEqual((1, 2), (e.start, e.end))
+
+        converter.setErrors('xmlcharrefreplace')
+        self.assertEqual(u'a&#8364;b'.encode('ascii'),
+                         converter.encode(u'a\u20acb', True))
+        converter.setErrors('backslashreplace')
+        self.assertEqual(u'a\\u20ACb'.encode('ascii'),
+                         converter.encode(u'a\u20acb', True))
+
+    def testConvert(self):
+
+        source = Converter('utf-8')
+        target = Converter('cp037')
+        data = u'Hello w\xf6rld'.encode('utf-8')
+        buffer = bytearray(4)
+        result = []
+        start = 0
+
+        while True:
+            read, written = source.convert(target, data[start:], buffer, True)
+            start += read
+            result.append(bytes(buffer[:written]))
+            if start == len(data) and written < len(buffer):
+                break
+
+        self.assertEqual(u'Hello w\xf6rld'.encode('cp037'), b''.join(result))
+        self.assertRaises(UnicodeEncodeError, source.convert,
+                          Converter('ascii'), data, bytearray(32), True)
+        self.assertRaises(InvalidArgsError, source.convert,
+                          source, data, buffer, True)
+
+        # the converter can't be replaced, another thread may be using it
+        self.assertRaises(RuntimeError, source.__init__, 'ascii')
+        self.assertEqual(source.getName(), 'UTF-8')
+
+    def testConvertThreads(self):
+
+        import threading
+
+        utf8 = Converter('utf-8')
+        latin1 = Converter('iso-8859-1')
+        text = u'caf\xe9 ' * 400  # long enough to release the GIL
+        errors = []
+
+        def convert(source, target, data):
+            try:
+                for i in range(2000):
+                    buffer = bytearray(len(data) * 2)
+                    read, written = source.convert(target, data, buffer, True)
+                    if read != len(data):
+                        errors.append((read, written))
+            except Exception as e:
+                errors.append(e)
+
+        threads = [
+            threading.Thread(target=convert, args=(
+                utf8, latin1, text.encode('utf-8'))),
+            threading.Thread(target=convert, args=(
+                latin1, utf8, text.encode('iso-8859-1'))),
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join(60)
+            self.assertFalse(thread.is_alive())
+
+        self.assertEqual([], errors)
+
+    def testConvertFile(self):
+
+        import tempfile, shutil
+
+        directory = tempfile.mkdtemp()
+        try:
+            inputPath = os.path.join(directory, 'input')
+            outputPath = os.path.join(directory, 'output')
+            text = u''.join(u'r\xe9cord %d\n' % i for i in range(10000))
+
+            with open(inputPath, 'wb') as f:
+                f.write(text.encode('cp037'))
+
+            source = Converter('cp037')
+            target = Converter('utf-8')
+            self.assertEqual((len(text), len(text.encode('utf-8'))),
+                             source.convertFile(target, inputPath,
+                                                outputPath, 1000))
+            with open(outputPath, 'rb') as f:
+                self.assertEqual(text, f.read().decode('utf-8'))
+
+            with open(inputPath, 'wb') as f:
+                f.write(b'x' * 5000 + b'\xff')
+            self.assertRaises(UnicodeDecodeError, target.convertFile,
+                              source, inputPath, outputPath, 1000)
+            self.assertRaises(IOError, source.convertFile,
+                              target, os.path.join(directory, 'missing'),
+                              outputPath)
+
+            # pivoted data left by convert() is dropped by convertFile()
+            a = Converter('iso-8859-1')
+            b = Converter('utf-8')
+            self.assertEqual(a.convert(b, b'abcdefghij', bytearray(4)),
+                             (10, 4))
+            with open(inputPath, 'wb') as f:
+                f.write(b'klm')
+            self.assertEqual(a.convertFile(b, inputPath, outputPath),
+                             (3, 3))
+            buffer = bytearray(16)
+            self.assertEqual(a.convert(b, b'XY', buffer, True), (2, 2))
+            self.assertEqual(bytes(buffer[:2]), b'XY')
+        finally:
+            shutil.rmtree(directory)
 
 
 if __name__ == "__main__":
@@ -21,7 +21,7 @@
 # ====================================================================
 #
 
-import sys, os, six
+import sys, os, six, struct, threading
 
 from unittest import TestCase, main
 from icu import *
@@ -156,6 +156,120 @@ class TestCollator(TestCase):
             if ICU_VERSION >= '51.0':
                 self.assertTrue(len(index.buildImmutableIndex()) == 28)
 
+    def testGetSortKeys(self):
+
+        collator = Collator.createInstance(Locale.getFrance())
+        names = [u'c\xf4te', u'cot\xe9', u'c\xf4t\xe9', u'cote', u'']
+        keys = [collator.getSortKey(name) for name in names]
+
+        self.assertEqual(collator.getSortKeys(names), keys)
+        self.assertEqual(collator.getSortKeys(iter(names)), keys)
+        self.assertEqual(collator.getSortKeys(()), [])
+
+        data, offsets = collator.getSortKeys(names, True)
+        offsets = struct.unpack('=%dq' % (len(offsets) // 8), offsets)
+        self.assertEqual(len(offsets), len(names) + 1)
+        self.assertEqual(offsets[-1], len(data))
+        self.assertEqual([data[offsets[i]:offsets[i + 1]]
+                          for i in range(len(names))], keys)
+
+        self.assertRaises(InvalidArgsError, collator.getSortKeys, u'cote')
+        self.assertRaises(InvalidArgsError, collator.getSortKeys, 3)
+
+        # every item is checked, not just the first one
+        mixed = [u'cote', UnicodeString(u'c\xf4te'), Locale.getFrance()]
+        self.assertRaises(TypeError, collator.getSortKeys, mixed)
+        self.assertRaises(TypeError, collator.sort, mixed)
+        self.assertRaises(TypeError, collator.argsort, mixed)
+        self.assertRaises(TypeError, collator.getSortKeys, [u'cote', 3])
+
+    def testSortStrings(self):
+
+        collator = Collator.createInstance(Locale.getFrance())
+        names = [u'cot\xe9', u'c\xf4te', u'cote', u'c\xf4t\xe9', u'cote',
+                 u'Cote', u'']
+        ordered = sorted(names, key=collator.getSortKey)
+
+        self.assertEqual(collator.sort(names), ordered)
+        self.assertEqual(collator.sort(iter(names)), ordered)
+        self.assertEqual(collator.sort(names, True),
+                         sorted(names, key=collator.getSortKey, reverse=True))
+        self.assertEqual(collator.sort([]), [])
+        self.assertEqual(
+            collator.argsort(names),
+            sorted(range(len(names)),
+                   key=lambda i: collator.getSortKey(names[i])))
+        self.assertEqual([names[i] for i in collator.argsort(names, True)],
+                         collator.sort(names, True))
+
+        strings = [UnicodeString(name) for name in names]
+        self.assertTrue(all(a is b for a, b in zip(
+            collator.sort(strings), [strings[i]
+                                     for i in collator.argsort(names)])))
+
+        self.assertRaises(InvalidArgsError, collator.sort, u'cote')
+
+        input = open(self.filePath('noms.txt'), 'rb')
+        names = [six.text_type(n.strip(), 'utf-8') for n in input.readlines()]
+        input.close()
+        ecole = names[0]
+        self.assertTrue(collator.sort(names)[2] is ecole)
+        self.assertEqual(collator.sort(names),
+                         sorted(names, key=collator.getSortKey))
+
+    def testThreads(self):
+
+        collator = Collator.createInstance(Locale.getFrance())
+        a = u'c\xf4te ' * 512
+        b = u'cot\xe9 ' * 512
+        key = collator.getSortKey(a)
+        results = []
+
+        def run():
+            for i in range(32):
+                results.append((collator.compare(a, b),
+                                collator.getSortKey(a) == key))
+
+        threads = [threading.Thread(target=run) for i in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        self.assertEqual(len(results), 128)
+        self.assertTrue(all(r == (collator.compare(a, b), True)
+                            for r in results))
+
+    def testSetterThreads(self):
+
+        collator = Collator.createInstance(Locale.getFrance())
+        a = u'c\xf4te ' * 512
+        keys = []
+        for strength in (Collator.PRIMARY, Collator.TERTIARY):
+            collator.setStrength(strength)
+            keys.append(collator.getSortKey(a))
+        results = []
+
+        def run():
+            for i in range(32):
+                results.append(collator.getSortKey(a) in keys)
+
+        def toggle():
+            for i in range(64):
+                collator.setStrength(Collator.PRIMARY)
+                collator.setAttribute(UCollAttribute.STRENGTH,
+                                      UCollAttributeValue.TERTIARY)
+
+        threads = [threading.Thread(target=run) for i in range(3)]
+        threads.append(threading.Thread(target=toggle))
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        self.assertEqual(len(results), 96)
+        self.assertTrue(all(results))
+
 
 if __name__ == "__main__":
     main()
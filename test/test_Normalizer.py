@@ -22,7 +22,7 @@
 # ====================================================================
 #
 
-import sys, os
+import sys, os, io
 
 from unittest import TestCase, main
 from icu import *
@@ -57,6 +57,72 @@ class TestNormalizer2(TestCase):
         self.assertNorm(Normalizer2.getNFKCCasefoldInstance(),
                         u"ässáw", u"äßa\u0301Ｗ")
 
+    def testNormalizedStrings(self):
+
+        nfc = Normalizer2.getNFCInstance()
+        nfkc = Normalizer2.getNFKCInstance()
+        nfkc_cf = Normalizer2.getNFKCCasefoldInstance()
+
+        # normalized strings are returned as is
+        for text in (u"hello", u"h\xe9llo", u"\u1e9bx", u""):
+            self.assertTrue(nfc.normalize(text) is text)
+
+        # the Latin-1 prefix is not normalized by nfkc and nfkc_cf
+        for text in (u"h\xe9llo\xa0world", u"Hello World", u"ab\xbd\u0301",
+                     u"abcde\u0301", u"\xa8\u0301x", u"x\U0001d15e"):
+            for normalizer in (nfc, nfkc, nfkc_cf):
+                expected = UnicodeString()
+                normalizer.normalize(text, expected)
+                self.assertEqual(expected, normalizer.normalize(text))
+                self.assertEqual(normalizer.isNormalized(UnicodeString(text)),
+                                 normalizer.isNormalized(text))
+                self.assertEqual(normalizer.quickCheck(UnicodeString(text)),
+                                 normalizer.quickCheck(text))
+
+        self.assertTrue(nfkc.isNormalized(u"hello"))
+        self.assertFalse(nfkc.isNormalized(u"hello\xa0"))
+        self.assertFalse(nfkc_cf.isNormalized(u"Hello"))
+        self.assertEqual(UNormalizationCheckResult.YES,
+                         nfc.quickCheck(u"h\xe9llo"))
+        self.assertEqual(UNormalizationCheckResult.MAYBE,
+                         nfc.quickCheck(u"hello\u0301"))
+
+    def testNormalizeStream(self):
+
+        nfc = Normalizer2.getNFCInstance()
+        text = u"e\u0301a\u0308\u0323 \u1100\u1161\u11a8Ｗ" * 50
+
+        # every chunk boundary, including those splitting combining sequences
+        for i in range(1, 12):
+            chunks = [text[j:j + i] for j in range(0, len(text), i)]
+            result = list(nfc.normalizeStream(chunks))
+            self.assertEqual(nfc.normalize(text), u''.join(result))
+            self.assertTrue(all(result))
+
+            result = nfc.normalizeStream(io.StringIO(text), i)
+            self.assertEqual(nfc.normalize(text), u''.join(result))
+
+        nfd = Normalizer2.getNFDInstance()
+        self.assertEqual(nfd.normalize(text),
+                         u''.join(nfd.normalizeStream(text)))
+        self.assertEqual([], list(nfd.normalizeStream([])))
+        self.assertRaises(TypeError, list, nfd.normalizeStream([u"a", 1]))
+
+        # bytes aren't decoded, a UTF-8 sequence may be split between chunks
+        data = u"caf\u00e9".encode('utf-8')
+        self.assertRaises(TypeError, list,
+                          nfd.normalizeStream([data[:4], data[4:]]))
+        self.assertRaises(TypeError, list,
+                          nfd.normalizeStream(io.BytesIO(data)))
+        self.assertRaises(InvalidArgsError, nfd.normalizeStream, data)
+        try:
+            list(nfd.normalizeStream([data]))
+        except TypeError as e:
+            self.assertEqual(str(e),
+                             "normalizeStream() chunks must be str, not bytes")
+        else:
+            self.fail("TypeError not raised")
+
 
 if __name__ == "__main__":
     main()
@@ -22,8 +22,10 @@
 # ====================================================================
 #
 
-import sys, os
+import sys, os, struct
 
+from array import array
+from decimal import Decimal
 from unittest import TestCase, main
 from icu import *
 
@@ -41,6 +43,61 @@ class TestNumberFormatter(TestCase):
         text = LocalizedNumberFormatter(Locale.getUS()).formatInt(1234)
         self.assertEqual(text, u'1,234')
 
+    def testFormatMany(self):
+
+        formatter = NumberFormatter.withLocale(Locale.getUS())
+
+        self.assertEqual(formatter.formatMany([1234, 2.5, Decimal('1.25'),
+                                               10 ** 20]),
+                         [u'1,234', u'2.5', u'1.25',
+                          u'100,000,000,000,000,000,000'])
+        self.assertEqual(formatter.formatMany(array('d', [1234.5, -1.0])),
+                         [u'1,234.5', u'-1'])
+        self.assertEqual(formatter.formatMany(array('q', [1234, 0])),
+                         [u'1,234', u'0'])
+        self.assertEqual(formatter.formatMany([]), [])
+
+        values = array('d', [i * 1.25 for i in range(2000)])
+        self.assertEqual(formatter.formatMany(values),
+                         [formatter.formatDouble(v) for v in values])
+
+        data, offsets = formatter.formatMany(array('q', [1, 1234, 12]), True)
+        self.assertEqual(data, b'11,23412')
+        self.assertEqual(struct.unpack('=4q', offsets), (0, 1, 6, 8))
+
+        self.assertRaises(InvalidArgsError, formatter.formatMany, u'1234')
+        self.assertRaises(InvalidArgsError, formatter.formatMany,
+                          array('i', [1234]))
+        self.assertRaises(InvalidArgsError, formatter.formatMany,
+                          memoryview(array('d', [1.0, 2.0, 3.0]))[::2])
+
+    def testGetInstance(self):
+
+        if ICU_VERSION < '62.0':
+            return
+
+        LocalizedNumberFormatter.clearCache()
+        LocalizedNumberFormatter.setCacheSize(2)
+        try:
+            formatter = LocalizedNumberFormatter.getInstance(
+                u'percent', Locale.getFrance())
+            self.assertEqual(formatter.formatDouble(25), u'25\xa0%')
+            self.assertTrue(formatter is LocalizedNumberFormatter.getInstance(
+                u'percent', 'fr_FR'))
+
+            LocalizedNumberFormatter.getInstance(u'percent', 'en_US')
+            LocalizedNumberFormatter.getInstance(u'percent', 'de_DE')
+            info = LocalizedNumberFormatter.getCacheInfo()
+            self.assertEqual((info['hits'], info['misses'], info['evictions'],
+                              info['size'], info['capacity']),
+                             (1, 3, 1, 2, 2))
+
+            self.assertRaises(ICUError, LocalizedNumberFormatter.getInstance,
+                              u'percent/bogus', 'en_US')
+        finally:
+            LocalizedNumberFormatter.clearCache()
+            LocalizedNumberFormatter.setCacheSize(64)
+
     def testFormattedNumber(self):
 
         if ICU_VERSION >= '64.0':
@@ -0,0 +1,159 @@
+# ====================================================================
+# Copyright (c) 2019 Open Source Applications Foundation.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions: 
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software. 
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+# ====================================================================
+#
+#
+
+import sys, os, re
+
+from unittest import TestCase, main
+from icu import *
+
+
+class TestRegex(TestCase):
+
+    def testCompileCache(self):
+
+        pattern = RegexPattern.compile(u"(\\w)+")
+        self.assertTrue(pattern is RegexPattern.compile(u"(\\w)+"))
+        self.assertFalse(pattern is RegexPattern.compile(
+            u"(\\w)+", URegexpFlag.CASE_INSENSITIVE))
+        self.assertEqual(RegexPattern.compile(
+            u"(\\w)+", URegexpFlag.CASE_INSENSITIVE).flags(),
+            URegexpFlag.CASE_INSENSITIVE)
+
+        info = RegexPattern.getCacheInfo()
+        self.assertTrue(info['hits'] >= 1)
+
+        RegexPattern.clearCache()
+        self.assertEqual(RegexPattern.getCacheInfo()['size'], 0)
+        self.assertFalse(pattern is RegexPattern.compile(u"(\\w)+"))
+
+        RegexPattern.setCacheSize(0)
+        self.assertFalse(RegexPattern.compile(u"a") is
+                         RegexPattern.compile(u"a"))
+        RegexPattern.setCacheSize(64)
+
+        self.assertRaises(ICUError, RegexPattern.compile, u"(")
+
+    def testFindall(self):
+
+        text = u"a1 \U0001f600b c3"
+        matcher = RegexPattern.compile(u"(\\w)(\\d)?").matcher(text)
+
+        spans = matcher.findall()
+        self.assertEqual(spans.format, 'i')
+        self.assertEqual(list(spans), [0, 2, 4, 5, 6, 8])
+        self.assertEqual(list(matcher.findall(2)), [1, 2, -1, -1, 7, 8])
+        self.assertEqual(text[4:5], u'b')
+        self.assertRaises(ICUError, matcher.findall, 3)
+
+        self.assertEqual(list(matcher.finditer()),
+                         [((0, 2), (0, 1), (1, 2)),
+                          ((4, 5), (4, 5), (-1, -1)),
+                          ((6, 8), (6, 7), (7, 8))])
+
+        matcher = RegexPattern.compile(u"x*").matcher(u"ab")
+        self.assertEqual(list(matcher.findall()), [0, 0, 1, 1, 2, 2])
+
+        # more groups than the initial span buffer holds
+        matcher = RegexPattern.compile(u"(a)" * 100).matcher(u"a" * 300)
+        matches = list(matcher.finditer())
+        self.assertEqual(len(matches), 3)
+        self.assertEqual(matches[2][0], (200, 300))
+        self.assertEqual(matches[2][100], (299, 300))
+
+    def testSub(self):
+
+        matcher = RegexPattern.compile(u"(\\w)(\\d)?").matcher(
+            u"a1 \U0001f600b c3")
+
+        self.assertEqual(matcher.sub(u"<$1>"), u"<a> \U0001f600<b> <c>")
+        self.assertEqual(matcher.sub(u"<$1>", 2), u"<a> \U0001f600<b> c3")
+        self.assertEqual(matcher.sub(lambda m: m.group(1).upper()),
+                         u"A \U0001f600B C")
+        self.assertRaises(TypeError, matcher.sub, lambda m: 0)
+
+        # the callable may not reset or move the matcher
+        self.assertRaises(RuntimeError, matcher.sub,
+                          lambda m: m.reset(u"xyz").input())
+        self.assertEqual(matcher.input(), u"xyz")
+        self.assertRaises(RuntimeError, matcher.sub,
+                          lambda m: m.reset() and u"")
+        self.assertRaises(RuntimeError, matcher.sub,
+                          lambda m: m.find() and m.group(1))
+        self.assertEqual(matcher.sub(lambda m: m.group(0).upper()), u"XYZ")
+
+    def testStrInput(self):
+
+        pattern = RegexPattern.compile(u"(\\w+) (\\w+)")
+        for text in (u"caf\u00e9 au lait " * 100,
+                     u"\u0100bc d\u0101e\u4e2d " * 100,
+                     u"\U0001f600ab cd " * 100):
+            expected = pattern.matcher(UnicodeString(text)).replaceAll(
+                u"$2 $1")
+            matcher = pattern.matcher(text)
+            self.assertEqual(matcher.replaceAll(u"$2 $1"), expected)
+            self.assertEqual(matcher.input(), text)
+
+            matcher.reset()
+            self.assertTrue(matcher.find())
+            self.assertEqual(matcher.group(2), re.match(
+                u"\\W*(\\w+) (\\w+)", text).group(2))
+
+            spans = list(matcher.findall(1))
+            self.assertEqual([text[spans[i]:spans[i + 1]]
+                              for i in range(0, len(spans), 2)],
+                             [match.group(1) for match in
+                              re.finditer(u"(\\w+) (\\w+)", text)])
+
+            matcher = pattern.matcher(u"")
+            matcher.reset(text)
+            self.assertEqual(matcher.input(), text)
+            self.assertEqual(matcher.sub(u"$2 $1"), expected)
+
+            # a UnicodeString input still referenced elsewhere is matched
+            # with the GIL held, one no longer referenced without it
+            u = UnicodeString(text)
+            matcher = pattern.matcher(u)
+            self.assertEqual(list(matcher.findall(1)), spans)
+            del u
+            self.assertEqual(list(matcher.findall(1)), spans)
+            self.assertEqual(matcher.replaceAll(u"$2 $1"), expected)
+
+    def testTimeLimit(self):
+
+        if ICU_VERSION >= '55.0':
+            matcher = RegexPattern.compile(u"(a+)+b").matcher(u"a" * 40)
+            matcher.setTimeLimit(1)
+            self.assertRaises(ICUError, matcher.findall)
+            self.assertRaises(ICUError, matcher.sub, u"")
+
+            def callback(steps):
+                raise ValueError(steps)
+
+            matcher = RegexPattern.compile(u"(a+)+b").matcher(u"a" * 40)
+            matcher.setMatchCallback(callback)
+            self.assertRaises(ValueError, matcher.finditer)
+
+
+if __name__ == "__main__":
+    main()
@@ -22,7 +22,7 @@
 # ====================================================================
 #
 
-import sys, os, six
+import sys, os, six, threading
 
 from unittest import TestCase, main
 from icu import *
@@ -80,6 +80,62 @@ class TestTransliterator(TestCase):
 
         self.assertTrue(regTrans.transliterate(string) == result)
 
+    def testPythonTransliteratorRun(self):
+
+        class upperRun(Transliterator):
+            def __init__(_self, filter=None):
+                if filter is None:
+                    super(upperRun, _self).__init__("upperRun")
+                else:
+                    super(upperRun, _self).__init__("upperRun", filter)
+            def transliterateRun(_self, run):
+                return run.upper().replace(u"\xdf", u"SS")
+
+        string = u"Gro\xdfe Chinesen mit dem Kontrabass"
+        self.assertEqual(u"GROSSE CHINESEN MIT DEM KONTRABASS",
+                         upperRun().transliterate(string))
+
+        # the text grows, the runs after the first one move
+        trans = upperRun(UnicodeSet(u"[^a-z]"))
+        self.assertEqual(u"GroSSe Chinesen mit dem Kontrabass",
+                         trans.transliterate(string))
+
+        Transliterator.registerInstance(upperRun())
+        trans = Transliterator.createInstance("upperRun; Any-Lower")
+        self.assertEqual(u"grosse chinesen mit dem kontrabass",
+                         trans.transliterate(string))
+
+        class badRun(Transliterator):
+            def __init__(_self):
+                super(badRun, _self).__init__("badRun")
+            def transliterateRun(_self, run):
+                return len(run)
+
+        try:
+            badRun().transliterate(string)
+        except TypeError as e:
+            self.assertEqual(str(e),
+                             "transliterateRun() must return str, not int")
+        else:
+            self.fail("TypeError not raised")
+
+    def testPythonTransliteratorWrappers(self):
+
+        texts = []
+
+        class keeper(Transliterator):
+            def __init__(_self):
+                super(keeper, _self).__init__("keeper")
+            def handleTransliterate(_self, text, pos, incremental):
+                texts.append(text)
+                text[pos.start] = u"X"
+                pos.start = pos.limit
+
+        trans = keeper()
+        self.assertEqual(u"Xbc", trans.transliterate(u"abc"))
+        self.assertEqual(u"Xef", trans.transliterate(u"def"))
+        self.assertFalse(texts[0] is texts[1])
+
     def testPythonTransliteratorException(self):
 
         class faultySubst(Transliterator):
@@ -91,6 +147,102 @@ class TestTransliterator(TestCase):
         trans = faultySubst()
         self.assertRaises(ValueError, trans.transliterate, "whatever")
 
+    def testThreads(self):
+
+        class vowelSubst(Transliterator):
+            def __init__(_self):
+                super(vowelSubst, _self).__init__("vowelThreads")
+            def handleTransliterate(_self, text, pos, incremental):
+                for i in range(pos.start, pos.limit):
+                    if text[i] in u"aeiou":
+                        text[i] = u'i'
+                pos.start = pos.limit
+
+        Transliterator.registerInstance(vowelSubst())
+
+        # long enough for the GIL to be released around transliterate(),
+        # the python transliterator reacquires it from within the compound
+        string = u"Drei Chinesen mit dem Kontrabass " * 64
+        result = u"DRII CHINISIN MIT DIM KINTRIBISS " * 64
+        trans = Transliterator.createInstance("vowelThreads; Any-Upper")
+        results = []
+
+        def run():
+            for i in range(16):
+                results.append(trans.transliterate(string))
+
+        threads = [threading.Thread(target=run) for i in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        self.assertEqual(len(results), 64)
+        self.assertTrue(all(r == result for r in results))
+
+    def testCache(self):
+
+        Transliterator.clearCache()
+        id = "Any-Latin; Latin-ASCII; Lower"
+        trans = Transliterator.createInstance(id)
+        other = Transliterator.createInstance(id)
+
+        # callers get their own copy of the cached transliterator
+        self.assertFalse(trans is other)
+        trans.adoptFilter(UnicodeSet(u"[a-z]"))
+        self.assertTrue(other.getFilter() is None)
+        self.assertEqual(u"moskva", other.transliterate(u"Москва"))
+
+        rules = u"a > b; b > a;"
+        self.assertEqual(u"ba", Transliterator.createFromRules(
+            "swap", rules).transliterate(u"ab"))
+        self.assertEqual(u"ba", Transliterator.createFromRules(
+            "swap", rules).transliterate(u"ab"))
+
+        info = Transliterator.getCacheInfo()
+        self.assertEqual(2, info['hits'])
+        self.assertEqual(2, info['misses'])
+        self.assertEqual(2, info['size'])
+
+        Transliterator.setCacheSize(1)
+        self.assertEqual(1, Transliterator.getCacheInfo()['size'])
+        Transliterator.setCacheSize(64)
+        Transliterator.clearCache()
+        self.assertEqual(0, Transliterator.getCacheInfo()['size'])
+
+    def testTransliterateMany(self):
+
+        trans = Transliterator.createInstance("Any-Latin; Latin-ASCII")
+        strings = [u"\u041c\u043e\u0441\u043a\u0432\u0430 %d" % i
+                   for i in range(200)]
+        expected = [trans.transliterate(string) for string in strings]
+
+        self.assertEqual(expected, trans.transliterateMany(strings))
+        self.assertEqual(expected, trans.transliterateMany(strings, 1))
+        self.assertEqual(expected, trans.transliterateMany(strings, 4))
+        self.assertEqual(expected, trans.transliterateMany(strings, 0))
+        self.assertEqual([], trans.transliterateMany([]))
+
+        class upper(Transliterator):
+            def __init__(_self):
+                super(upper, _self).__init__("upperMany")
+            def handleTransliterate(_self, text, pos, incremental):
+                for i in range(pos.start, pos.limit):
+                    text[i] = text[i].upper()
+                pos.start = pos.limit
+
+        self.assertEqual([u"ABC"] * 100,
+                         upper().transliterateMany([u"abc"] * 100, 4))
+
+        class faulty(Transliterator):
+            def __init__(_self):
+                super(faulty, _self).__init__("faultyMany")
+            def handleTransliterate(_self, text, pos, incremental):
+                raise ValueError("faulty")
+
+        self.assertRaises(ValueError, faulty().transliterateMany,
+                          [u"abc"] * 100, 4)
+
 
 if __name__ == "__main__":
     main()
@@ -21,7 +21,7 @@
 # ====================================================================
 #
 
-import sys, os
+import sys, os, six
 
 from unittest import TestCase, main
 from icu import *
@@ -40,6 +40,45 @@ class Tests(TestCase):
                          "Failed to collate low character before high",
                          )
 
+    def testStringArguments(self):
+
+        # latin-1, BMP and astral strings are stored differently by python
+        for string in (u'caf\xe9', u'\u0109apelo \u62d5',
+                       u'a\U0001f600b\xe9\U00010000', u'\ud800x', u''):
+            for text in (string, string * 100):
+                u = UnicodeString(text)
+                self.assertEqual(six.text_type(u), text)
+                size = len(text.encode('utf-16-le', 'surrogatepass')) // 2
+                self.assertEqual(len(u), size)
+
+                # modifying a string argument doesn't modify the python string
+                u = UnicodeString(text)
+                u.append(u'!')
+                self.assertEqual(six.text_type(u), text + u'!')
+
+                normalizer = Normalizer2.getNFCInstance()
+                self.assertEqual(normalizer.normalize(text), text)
+                self.assertTrue(normalizer.isNormalized(text))
+
+    def testBytesArguments(self):
+
+        for string in (u'abc' * 100, u'caf\xe9 \U0001f600', u''):
+            for encoding in ('utf-8', 'latin-1', 'shift_jis', 'utf-16-le'):
+                try:
+                    data = string.encode(encoding)
+                except UnicodeEncodeError:
+                    continue
+                # decoding twice reuses the converter
+                for i in range(2):
+                    u = UnicodeString(data, encoding)
+                    self.assertEqual(six.text_type(u), string)
+
+        self.assertRaises(ValueError, UnicodeString, b'caf\xe9', 'utf-8')
+        self.assertRaises(ValueError, UnicodeString, b'caf\xe9', 'ascii')
+        self.assertEqual(six.text_type(UnicodeString(b'caf\xe9', 'utf-8',
+                                                     'replace')),
+                         u'caf\ufffd')
+
 
 if __name__ == "__main__":
     main()
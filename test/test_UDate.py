@@ -21,10 +21,10 @@
 # ====================================================================
 #
 
-import sys, os
+import sys, os, array
 
 from unittest import TestCase, main
-from datetime import datetime
+from datetime import datetime, timedelta, tzinfo
 from icu import *
 
 class TestUDate(TestCase):
@@ -44,6 +44,163 @@ class TestUDate(TestCase):
 
         self.assertTrue(before == after)
 
+    def testConvertDatetime(self):
+
+        class FixedOffset(tzinfo):
+            def utcoffset(self, dt):
+                return timedelta(hours=-5)
+
+        def udate(dt):
+            calendar = Calendar.createInstance()
+            calendar.setTime(dt)
+            return calendar.getTime()
+
+        def expected(dt, tz):
+            offset = tz.utcoffset(dt.replace(tzinfo=None))
+            epoch = datetime(1970, 1, 1)
+            return ((dt.replace(tzinfo=None) - epoch) - offset).total_seconds()
+
+        default = ICUtzinfo.getDefault()
+        newYork = ICUtzinfo.getInstance('America/New_York')
+        paris = ICUtzinfo.getInstance('Europe/Paris')
+
+        try:
+            ICUtzinfo.setDefault(paris)
+            for dt in (datetime(2006, 4, 18, 5, 12),
+                       datetime(1969, 12, 31, 23, 30, 0, 500000),
+                       datetime(2021, 3, 14, 2, 30),
+                       datetime(2021, 11, 7, 1, 30),
+                       datetime(1900, 3, 1), datetime(2000, 2, 29, 12)):
+                self.assertEqual(udate(dt), expected(dt, paris))
+                self.assertEqual(udate(dt.replace(tzinfo=newYork)),
+                                 expected(dt, newYork))
+                self.assertEqual(
+                    udate(dt.replace(tzinfo=ICUtzinfo.getFloating())),
+                    expected(dt, paris))
+                self.assertEqual(udate(dt.replace(tzinfo=FixedOffset())),
+                                 expected(dt, FixedOffset()))
+
+            # naive datetimes follow the default ICUtzinfo
+            dt = datetime(2006, 4, 18, 5, 12)
+            ICUtzinfo.setDefault(newYork)
+            self.assertEqual(udate(dt), expected(dt, newYork))
+        finally:
+            ICUtzinfo.setDefault(default)
+
+    def testTZInfoOffsets(self):
+
+        def expected(tz, dt):
+            millis = ((dt.hour * 60 + dt.minute) * 60 + dt.second) * 1000
+            dayOfWeek = (dt.weekday() + 1) % 7 + 1
+            offset = tz.getOffset(GregorianCalendar.AD, dt.year,
+                                  dt.month - 1, dt.day, dayOfWeek, millis)
+            return timedelta(seconds=int(offset / 1000))
+
+        for id in ('America/New_York', 'Europe/Paris', 'Australia/Lord_Howe',
+                   'Asia/Kolkata', 'America/St_Johns'):
+            tzinfo = ICUtzinfo.getInstance(id)
+            dt = datetime(1790, 1, 1)
+            while dt.year < 2210:
+                # crosses transitions at all times of day
+                dt += timedelta(days=13, minutes=47)
+                self.assertEqual(tzinfo.utcoffset(dt),
+                                 expected(tzinfo.timezone, dt))
+
+            # around the 2021 transitions, including skipped and repeated
+            for dt in (datetime(2021, 3, 14, 1, 59), datetime(2021, 3, 14, 2),
+                       datetime(2021, 3, 14, 2, 30), datetime(2021, 3, 14, 3),
+                       datetime(2021, 11, 7, 0, 59), datetime(2021, 11, 7, 1),
+                       datetime(2021, 11, 7, 1, 30), datetime(2021, 11, 7, 2),
+                       datetime(2021, 3, 28, 2, 30), datetime(2021, 10, 31, 2, 30),
+                       datetime(2021, 4, 4, 1, 45), datetime(2021, 10, 3, 2, 15)):
+                self.assertEqual(tzinfo.utcoffset(dt),
+                                 expected(tzinfo.timezone, dt))
+
+        tzinfo = ICUtzinfo.getInstance('America/New_York')
+        self.assertEqual(tzinfo.dst(datetime(2021, 7, 1)), timedelta(hours=1))
+        self.assertEqual(tzinfo.dst(datetime(2021, 1, 1)), timedelta(0))
+        self.assertTrue(tzinfo.utcoffset(datetime(2021, 7, 1)) is
+                        tzinfo.utcoffset(datetime(2020, 7, 1)))
+
+        # zones that can be modified are not cached
+        zone = SimpleTimeZone(3600000, 'Custom')
+        tzinfo = ICUtzinfo(zone)
+        self.assertEqual(tzinfo.utcoffset(datetime(2021, 7, 1)),
+                         timedelta(hours=1))
+        zone.setRawOffset(7200000)
+        self.assertEqual(tzinfo.utcoffset(datetime(2021, 7, 1)),
+                         timedelta(hours=2))
+
+    def testGetOffsets(self):
+
+        tz = TimeZone.createTimeZone('Europe/Paris')
+        step = 86400000.0 * 3 + 3600000.0 * 5 + 60000.0 * 7
+        dates = array.array('d', [-5e12 + i * step for i in range(4096)])
+        dates.extend([1616893200000.0, 1616893199999.0, -1e15, 1e15])
+
+        offsets = array.array('i', [0] * (len(dates) * 2))
+        self.assertTrue(tz.getOffsets(dates, offsets) is offsets)
+        for i, date in enumerate(dates):
+            self.assertEqual((offsets[i * 2], offsets[i * 2 + 1]),
+                             tz.getOffset(date / 1000.0, False))
+
+        # without an output buffer, a bytearray is returned
+        self.assertEqual(bytes(tz.getOffsets(dates)), offsets.tobytes())
+        self.assertEqual(len(tz.getOffsets(array.array('d'))), 0)
+
+        # with the transitions cached by the calls above
+        self.assertEqual(bytes(tz.getOffsets(dates[4000:4010])),
+                         offsets[8000:8020].tobytes())
+
+        # the cached transitions of a modified zone are dropped
+        zone = SimpleTimeZone(3600000, 'Custom', 2, -1, 1, 3600000,
+                              9, -1, 1, 3600000)
+        dates = array.array('d', [1616800000000.0 + i * 3600000.0
+                                  for i in range(8760)])
+        offsets = array.array('i', bytes(zone.getOffsets(dates)))
+        self.assertEqual(set(offsets[1::2]), set([0, 3600000]))
+        zone.setRawOffset(7200000)
+        zone.setDSTSavings(1800000)
+        offsets = array.array('i', bytes(zone.getOffsets(dates)))
+        self.assertEqual(set(offsets[0::2]), set([7200000]))
+        self.assertEqual(set(offsets[1::2]), set([0, 1800000]))
+        for i in range(0, len(dates), 97):
+            self.assertEqual((offsets[i * 2], offsets[i * 2 + 1]),
+                             zone.getOffset(dates[i] / 1000.0, False))
+
+        self.assertRaises(InvalidArgsError, tz.getOffsets,
+                          array.array('f', [0.0]))
+        self.assertRaises(InvalidArgsError, tz.getOffsets,
+                          dates, array.array('i', [0]))
+        self.assertRaises(InvalidArgsError, tz.getOffsets, [0.0])
+
+    def testFormatMany(self):
+
+        step = 3600000.0 * 5 + 60000.0 * 7 + 1234.5
+        dates = array.array('d', [1616800000000.0 + i * step
+                                  for i in range(512)])
+        dates.extend([0.0, -0.5, 1e16, float('nan')])
+
+        for pattern in ("yyyy-MM-dd'T'HH:mm:ss.SSS", "EEEE d MMMM y h:mm a",
+                        "'it''s' k 'o''clock' zzzz", "SSSS A", "y"):
+            for locale in ('en_US', 'fr_FR', 'ar_EG', 'ja_JP@calendar=japanese'):
+                format = SimpleDateFormat(pattern, Locale(locale))
+                format.setTimeZone(TimeZone.createTimeZone('Europe/Paris'))
+                self.assertEqual(format.formatMany(dates),
+                                 [format.format(date / 1000.0)
+                                  for date in dates])
+
+        format = DateFormat.createDateInstance(DateFormat.kShort,
+                                               Locale.getUS())
+        format.setTimeZone(TimeZone.getGMT())
+        self.assertEqual(format.formatMany(array.array('d', [0.0, 1e12])),
+                         [u'1/1/70', u'9/9/01'])
+        data, offsets = format.formatMany(array.array('d', [0.0, 1e12]), True)
+        self.assertEqual(data, b'1/1/709/9/01')
+        self.assertEqual(array.array('q', offsets).tolist(), [0, 6, 12])
+
+        self.assertRaises(InvalidArgsError, format.formatMany, [0.0])
+
 
 if __name__ == "__main__":
     main()
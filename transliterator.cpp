@@ -21,6 +21,12 @@
  * ====================================================================
  */
 
+#if defined(_MSC_VER) || defined(__WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "common.h"
 #include "structmember.h"
 
@@ -77,6 +83,7 @@ static PyObject *t_transliterator_toRules(t_transliterator *self, PyObject *args
 static PyObject *t_transliterator_transliterate(t_transliterator *self, PyObject *args);
 static PyObject *t_transliterator_finishTransliteration(t_transliterator *self, PyObject *args);
 static PyObject *t_transliterator_filteredTransliterate(t_transliterator *self, PyObject *args);
+static PyObject *t_transliterator_transliterateMany(t_transliterator *self, PyObject *args);
 static PyObject *t_transliterator_getFilter(t_transliterator *self);
 static PyObject *t_transliterator_orphanFilter(t_transliterator *self);
 static PyObject *t_transliterator_adoptFilter(t_transliterator *self, PyObject *arg);
@@ -84,11 +91,15 @@ static PyObject *t_transliterator_getAvailableIDs(PyTypeObject *type);
 static PyObject *t_transliterator_createInstance(PyTypeObject *type, PyObject *args);
 static PyObject *t_transliterator_createFromRules(PyTypeObject *type, PyObject *args);
 static PyObject *t_transliterator_registerInstance(PyTypeObject *type, PyObject *args);
+static PyObject *t_transliterator_getCacheInfo(PyTypeObject *type);
+static PyObject *t_transliterator_setCacheSize(PyTypeObject *type, PyObject *arg);
+static PyObject *t_transliterator_clearCache(PyTypeObject *type);
 
 static PyMethodDef t_transliterator_methods[] = {
     DECLARE_METHOD(t_transliterator, transliterate, METH_VARARGS),
     DECLARE_METHOD(t_transliterator, finishTransliteration, METH_VARARGS),
     DECLARE_METHOD(t_transliterator, filteredTransliterate, METH_VARARGS),
+    DECLARE_METHOD(t_transliterator, transliterateMany, METH_VARARGS),
     DECLARE_METHOD(t_transliterator, getMaximumContextLength, METH_NOARGS),
     DECLARE_METHOD(t_transliterator, countElements, METH_NOARGS),
     DECLARE_METHOD(t_transliterator, getElement, METH_O),
@@ -103,23 +114,40 @@ static PyMethodDef t_transliterator_methods[] = {
     DECLARE_METHOD(t_transliterator, createInstance, METH_VARARGS | METH_CLASS),
     DECLARE_METHOD(t_transliterator, createFromRules, METH_VARARGS | METH_CLASS),
     DECLARE_METHOD(t_transliterator, registerInstance, METH_VARARGS | METH_CLASS),
+    DECLARE_METHOD(t_transliterator, getCacheInfo, METH_NOARGS | METH_CLASS),
+    DECLARE_METHOD(t_transliterator, setCacheSize, METH_O | METH_CLASS),
+    DECLARE_METHOD(t_transliterator, clearCache, METH_NOARGS | METH_CLASS),
     { NULL, NULL, 0, NULL }
 };
 
+static void t_transliterator_dealloc(t_transliterator *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(Transliterator, t_transliterator, UObject,
-             Transliterator, t_transliterator_init, NULL)
+             Transliterator, t_transliterator_init, t_transliterator_dealloc)
 
 
 /* PythonTransliterator */
 
 UOBJECT_DEFINE_RTTI_IMPLEMENTATION(PythonTransliterator)
 
+static PyObject *handleTransliterate_NAME;
+static PyObject *transliterateRun_NAME;
+
 PythonTransliterator::PythonTransliterator(t_transliterator *self,
                                            UnicodeString &id) :
     Transliterator(id, NULL)
 {
     this->self = self;
-    Py_XINCREF(this->self);
+    init();
 }
 
 PythonTransliterator::PythonTransliterator(t_transliterator *self,
@@ -128,7 +156,7 @@ PythonTransliterator::PythonTransliterator(t_transliterator *self,
     Transliterator(id, adoptedFilter)
 {
     this->self = self;
-    Py_XINCREF(this->self);
+    init();
 }
 
 /**
@@ -137,14 +165,36 @@ PythonTransliterator::PythonTransliterator(t_transliterator *self,
 PythonTransliterator::PythonTransliterator(const PythonTransliterator& p) :
     Transliterator(p)
 {
+    PyGILState_STATE state = PyGILState_Ensure();
+
     this->self = p.self;
+    this->wholeRun = p.wholeRun;
+    this->textWrapper = NULL;
+    this->posWrapper = NULL;
     Py_XINCREF(this->self);
+
+    PyGILState_Release(state);
 }
 
 PythonTransliterator::~PythonTransliterator()
 {
-    Py_XDECREF(this->self);
-    this->self = NULL;
+    PyGILState_STATE state = PyGILState_Ensure();
+
+    Py_CLEAR(this->textWrapper);
+    Py_CLEAR(this->posWrapper);
+    Py_CLEAR(this->self);
+
+    PyGILState_Release(state);
+}
+
+// called with the GIL, from the python constructor
+void PythonTransliterator::init()
+{
+    wholeRun = self != NULL &&
+        PyObject_HasAttr((PyObject *) Py_TYPE(self), transliterateRun_NAME);
+    textWrapper = NULL;
+    posWrapper = NULL;
+    Py_XINCREF(self);
 }
 
 Transliterator* PythonTransliterator::clone(void) const
@@ -152,23 +202,122 @@ Transliterator* PythonTransliterator::clone(void) const
     return new PythonTransliterator(*this);
 }
 
+static PyObject *callMethod(PyObject *self, PyObject *name,
+                            PyObject *arg0, PyObject *arg1, PyObject *arg2)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject *args[] = { self, arg0, arg1, arg2 };
+    size_t nargs = arg1 == NULL ? 2 : 4;
+
+    return PyObject_VectorcallMethod(
+        name, args, nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL);
+#else
+    return PyObject_CallMethodObjArgs(self, name, arg0, arg1, arg2, NULL);
+#endif
+}
+
+/* The wrappers passed to handleTransliterate() are reused for the next
+ * call, unless the python callback kept a reference to them.
+ */
+static PyObject *rewrapText(PyObject *&cached, UnicodeString *text)
+{
+    if (cached != NULL && Py_REFCNT(cached) == 1)
+        ((t_uobject *) cached)->object = text;
+    else
+    {
+        Py_XDECREF(cached);
+        if ((cached = wrap_UnicodeString(text, 0)) == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(cached);
+    return cached;
+}
+
+static PyObject *rewrapPosition(PyObject *&cached, UTransPosition *pos)
+{
+    if (cached != NULL && Py_REFCNT(cached) == 1)
+        ((t_utransposition *) cached)->object = pos;
+    else
+    {
+        Py_XDECREF(cached);
+        if ((cached = wrap_UTransPosition(pos, 0)) == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(cached);
+    return cached;
+}
+
 void PythonTransliterator::handleTransliterate(Replaceable& text,
                                                UTransPosition& pos,
                                                UBool incremental) const
 {
-    if (ISINSTANCE(&text, UnicodeString))
+    // may be called with the GIL released, as part of a compound
+    PyGILState_STATE state = PyGILState_Ensure();
+
+    if (wholeRun)
+        transliterateRun(text, pos);
+    else if (ISINSTANCE(&text, UnicodeString))
+    {
+        PyObject *p_text = rewrapText(textWrapper, (UnicodeString *) &text);
+        PyObject *p_pos = rewrapPosition(posWrapper, &pos);
+
+        if (p_text != NULL && p_pos != NULL)
+        {
+            PyObject *result = callMethod(
+                (PyObject *) self, handleTransliterate_NAME, p_text, p_pos,
+                incremental ? Py_True : Py_False);
+
+            Py_XDECREF(result);
+        }
+
+        Py_XDECREF(p_text);
+        Py_XDECREF(p_pos);
+    }
+
+    PyGILState_Release(state);
+}
+
+/* The whole run between pos.start and pos.limit is passed, as a str, to
+ * self.transliterateRun() and replaced with the str it returns.
+ */
+void PythonTransliterator::transliterateRun(Replaceable& text,
+                                            UTransPosition& pos) const
+{
+    UnicodeString run;
+
+    text.extractBetween(pos.start, pos.limit, run);
+
+    PyObject *p_run = PyUnicode_FromUnicodeString(&run);
+
+    if (p_run == NULL)
+        return;
+
+    PyObject *result = callMethod((PyObject *) self, transliterateRun_NAME,
+                                  p_run, NULL, NULL);
+
+    Py_DECREF(p_run);
+
+    if (result != NULL)
     {
-        PyObject *name = PyString_FromString("handleTransliterate");
-        PyObject *p_text = wrap_UnicodeString((UnicodeString *) &text, 0);
-        PyObject *p_pos = wrap_UTransPosition(&pos, 0);
-        PyObject *result =
-            PyObject_CallMethodObjArgs((PyObject *) self, name, p_text, p_pos,
-                                       incremental ? Py_True : Py_False, NULL);
+        UnicodeString *u, _u;
+
+        if (!parseArg(result, "S", &u, &_u))
+        {
+            int32_t delta = u->length() - (pos.limit - pos.start);
 
-        Py_DECREF(name);
-        Py_DECREF(p_text);
-        Py_DECREF(p_pos);
-        Py_XDECREF(result);
+            text.handleReplaceBetween(pos.start, pos.limit, *u);
+            pos.limit += delta;
+            pos.contextLimit += delta;
+            pos.start = pos.limit;
+        }
+        else
+            PyErr_Format(PyExc_TypeError,
+                         "transliterateRun() must return str, not %s",
+                         Py_TYPE(result)->tp_name);
+
+        Py_DECREF(result);
     }
 }
 
@@ -316,8 +465,8 @@ static int t_transliterator_init(t_transliterator *self,
         PyErr_SetArgsError((PyObject *) self, "__init__", args);
         return -1;
       case 2:
-        if (!parseArgs(args, "SP", &u, &_u, TYPE_CLASSID(UnicodeFilter),
-                       &adoptedFilter))
+        if (!parseArgs(args, "SP", TYPE_CLASSID(UnicodeFilter),
+                       &u, &_u, &adoptedFilter))
         {
             self->object = new PythonTransliterator(self, *u, (UnicodeFilter *) adoptedFilter->clone());
             self->flags = T_OWNED;
@@ -379,6 +528,7 @@ static PyObject *t_transliterator_transliterate(t_transliterator *self,
     PythonReplaceable *rep;
 #endif
     UChar32 c;
+    ObjectLocker locker(self->lock);
 
     switch (PyTuple_Size(args)) {
       case 1:
@@ -389,7 +539,9 @@ static PyObject *t_transliterator_transliterate(t_transliterator *self,
         }
         if (!parseArgs(args, "s", &_u0))
         {
-            PYTHON_CALL(self->object->transliterate(_u0));
+            PYTHON_CALL(ALLOW_THREADS_CALL(
+                allowThreads(_u0.length()),
+                self->object->transliterate(_u0)));
             return PyUnicode_FromUnicodeString(&_u0);
         }
 #if U_ICU_VERSION_HEX >= VERSION_HEX(55, 0, 0)
@@ -427,7 +579,9 @@ static PyObject *t_transliterator_transliterate(t_transliterator *self,
         }
         if (!parseArgs(args, "sii", &_u0, &start, &limit))
         {
-            PYTHON_CALL(self->object->transliterate(_u0, start, limit));
+            PYTHON_CALL(ALLOW_THREADS_CALL(
+                allowThreads(_u0.length()),
+                self->object->transliterate(_u0, start, limit)));
             return PyUnicode_FromUnicodeString(&_u0);
         }
 #if U_ICU_VERSION_HEX >= VERSION_HEX(55, 0, 0)
@@ -494,6 +648,7 @@ static PyObject *t_transliterator_finishTransliteration(t_transliterator *self,
 #if U_ICU_VERSION_HEX >= VERSION_HEX(55, 0, 0)
     PythonReplaceable *rep;
 #endif
+    ObjectLocker locker(self->lock);
 
     if (!parseArgs(args, "UO", &UTransPositionType_, &u, &utransposition))
     {
@@ -525,6 +680,7 @@ static PyObject *t_transliterator_filteredTransliterate(t_transliterator *self,
 #if U_ICU_VERSION_HEX >= VERSION_HEX(55, 0, 0)
     PythonReplaceable *rep;
 #endif
+    ObjectLocker locker(self->lock);
 
     if (!parseArgs(args, "UOB", &UTransPositionType_, &u, &utransposition,
                    &incremental))
@@ -552,6 +708,230 @@ static PyObject *t_transliterator_filteredTransliterate(t_transliterator *self,
     return PyErr_SetArgsError((PyObject *) self, "filteredTransliterate", args);
 }
 
+/* transliterateMany() hands out the strings to its threads by batches of
+ * TRANSLITERATE_BATCH_SIZE, round robin, and starts no more threads than
+ * there are batches. It uses one thread unless asked for more, 0 for one
+ * per cpu: rule-based transliterators all take ICU's global
+ * transliteratorDataMutex, so more threads may not be any faster.
+ */
+#define TRANSLITERATE_BATCH_SIZE 16
+
+struct transliterateTask {
+    const Transliterator *transliterator;
+    UnicodeString *texts;
+    Py_ssize_t count;
+    int index, threads;
+    PyThread_type_lock done;   // held until the task is finished
+};
+
+static void transliterateBatches(transliterateTask *task)
+{
+    const Py_ssize_t step = TRANSLITERATE_BATCH_SIZE * task->threads;
+
+    for (Py_ssize_t i = TRANSLITERATE_BATCH_SIZE * task->index;
+         i < task->count; i += step) {
+        Py_ssize_t end = i + TRANSLITERATE_BATCH_SIZE;
+
+        if (end > task->count)
+            end = task->count;
+
+        for (Py_ssize_t j = i; j < end; ++j)
+            task->transliterator->transliterate(task->texts[j]);
+    }
+}
+
+static void transliterateThread(void *arg)
+{
+    transliterateTask *task = (transliterateTask *) arg;
+
+    transliterateBatches(task);
+    PyThread_release_lock(task->done);
+}
+
+static int cpuCount()
+{
+#if defined(_MSC_VER) || defined(__WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (int) info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+
+/* Python transliterators, even within a compound, need the GIL and report
+ * errors in the thread calling them: they're not run in other threads.
+ */
+static bool isPythonTransliterator(const Transliterator *transliterator)
+{
+    if (transliterator->getDynamicClassID() ==
+        PythonTransliterator::getStaticClassID())
+        return true;
+
+    int32_t count = transliterator->countElements();
+
+    if (count > 1)
+    {
+        for (int32_t i = 0; i < count; ++i) {
+            UErrorCode status = U_ZERO_ERROR;
+            const Transliterator &element =
+                transliterator->getElement(i, status);
+
+            if (U_SUCCESS(status) && isPythonTransliterator(&element))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+static void transliterateInThreads(const Transliterator *transliterator,
+                                   UnicodeString *texts, Py_ssize_t count,
+                                   int threads)
+{
+    int batches = (int) ((count + TRANSLITERATE_BATCH_SIZE - 1) /
+                         TRANSLITERATE_BATCH_SIZE);
+
+    if (threads == 0)
+        threads = cpuCount();
+    if (threads > batches)
+        threads = batches;
+    if (threads < 1)
+        return;
+
+    // the first task runs in this thread on the transliterator, the others
+    // run in new threads on clones of it
+    transliterateTask *tasks = new transliterateTask[threads];
+    int started = 1;
+
+    for (int i = 0; i < threads; ++i) {
+        tasks[i].transliterator = transliterator;
+        tasks[i].texts = texts;
+        tasks[i].count = count;
+        tasks[i].index = i;
+        tasks[i].threads = threads;
+        tasks[i].done = NULL;
+    }
+
+    for (; started < threads; ++started) {
+        transliterateTask *task = &tasks[started];
+
+        task->done = PyThread_allocate_lock();
+        if (task->done == NULL)
+            break;
+
+        task->transliterator = transliterator->clone();
+        if (task->transliterator == NULL)
+        {
+            task->transliterator = transliterator;
+            PyThread_free_lock(task->done);
+            task->done = NULL;
+            break;
+        }
+        PyThread_acquire_lock(task->done, WAIT_LOCK);
+
+        if (PyThread_start_new_thread(transliterateThread, task) ==
+            (unsigned long) -1)
+        {
+            delete task->transliterator;
+            task->transliterator = transliterator;
+            PyThread_free_lock(task->done);
+            task->done = NULL;
+            break;
+        }
+    }
+
+    // batches of tasks that couldn't be started are run in this thread
+    Py_BEGIN_ALLOW_THREADS
+    for (int i = 0; i < threads; ++i) {
+        if (i == 0 || i >= started)
+            transliterateBatches(&tasks[i]);
+        else
+            PyThread_acquire_lock(tasks[i].done, WAIT_LOCK);
+    }
+    Py_END_ALLOW_THREADS
+
+    for (int i = 1; i < started; ++i) {
+        delete tasks[i].transliterator;
+        PyThread_free_lock(tasks[i].done);
+    }
+    delete[] tasks;
+}
+
+static PyObject *t_transliterator_transliterateMany(t_transliterator *self,
+                                                    PyObject *args)
+{
+    PyObject *strings;
+    int threads = 1;
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "K", &strings))
+            break;
+        return PyErr_SetArgsError((PyObject *) self, "transliterateMany", args);
+      case 2:
+        if (!parseArgs(args, "Ki", &strings, &threads) && threads >= 0)
+            break;
+      default:
+        return PyErr_SetArgsError((PyObject *) self, "transliterateMany", args);
+    }
+
+    PyObject *sequence = PySequence_Fast(strings, "a sequence is required");
+
+    if (sequence == NULL)
+        return NULL;
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+    UnicodeString *texts = new UnicodeString[count];
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject *item = PySequence_Fast_GET_ITEM(sequence, i);
+        UnicodeString *u, _u;
+
+        if (parseArg(item, "S", &u, &_u))
+        {
+            Py_DECREF(sequence);
+            delete[] texts;
+
+            return PyErr_SetArgsError((PyObject *) self, "transliterateMany",
+                                      args);
+        }
+
+        texts[i] = *u;  // a copy, even of an aliased str
+    }
+    Py_DECREF(sequence);
+
+    ObjectLocker locker(self->lock);
+
+    if (isPythonTransliterator(self->object))
+    {
+        // with the GIL, stopping at the first python error
+        for (Py_ssize_t i = 0; i < count && !PyErr_Occurred(); ++i)
+            self->object->transliterate(texts[i]);
+    }
+    else
+        transliterateInThreads(self->object, texts, count, threads);
+
+    PyObject *result = PyErr_Occurred() ? NULL : PyList_New(count);
+
+    for (Py_ssize_t i = 0; result != NULL && i < count; ++i) {
+        PyObject *string = PyUnicode_FromUnicodeString(&texts[i]);
+
+        if (string == NULL)
+            Py_CLEAR(result);
+        else
+            PyList_SET_ITEM(result, i, string);
+    }
+    delete[] texts;
+
+    return result;
+}
+
 static PyObject *t_transliterator_getMaximumContextLength(t_transliterator *self)
 {
     return PyInt_FromLong(self->object->getMaximumContextLength());
@@ -602,6 +982,7 @@ static PyObject *t_transliterator_createInverse(t_transliterator *self)
 
 static PyObject *t_transliterator_getFilter(t_transliterator *self)
 {
+    ObjectLocker locker(self->lock);
     const UnicodeFilter *filter = self->object->getFilter();
 
     if (filter == NULL)
@@ -612,6 +993,7 @@ static PyObject *t_transliterator_getFilter(t_transliterator *self)
 
 static PyObject *t_transliterator_orphanFilter(t_transliterator *self)
 {
+    ObjectLocker locker(self->lock);
     UnicodeFilter *filter = self->object->orphanFilter();
 
     if (filter == NULL)
@@ -624,6 +1006,7 @@ static PyObject *t_transliterator_adoptFilter(t_transliterator *self,
                                               PyObject *arg)
 {
     UnicodeFilter *filter;
+    ObjectLocker locker(self->lock);
 
     if (arg == Py_None)
         self->object->adoptFilter(NULL);
@@ -643,29 +1026,113 @@ static PyObject *t_transliterator_getAvailableIDs(PyTypeObject *type)
     return wrap_StringEnumeration(se, T_OWNED);
 }
 
+/* Transliterators compiled by createInstance() and createFromRules(), keyed
+ * by their arguments. The cached prototypes are never returned, callers get
+ * clones of them that they may modify.
+ */
+static LRUCache transliteratorCache(64);
+
+// steals the reference to prototype
+static PyObject *clonePrototype(PyObject *prototype)
+{
+    if (prototype == NULL)
+        return NULL;
+
+    PyObject *result =
+        wrap_Transliterator(*((t_transliterator *) prototype)->object);
+
+    Py_DECREF(prototype);
+    return result;
+}
+
+// returns a new reference to the cached prototype for the transliterator
+static PyObject *cachePrototype(PyObject *key, Transliterator *transliterator)
+{
+    PyObject *prototype = wrap_Transliterator(transliterator);
+
+    if (prototype != NULL && transliteratorCache.insert(key, prototype) < 0)
+        Py_CLEAR(prototype);
+
+    return prototype;
+}
+
+static PyObject *createInstance(const UnicodeString &id,
+                                UTransDirection direction)
+{
+    PyObject *key = Py_BuildValue("(Ni)", PyUnicode_FromUnicodeString(&id),
+                                  (int) direction);
+
+    if (key == NULL)
+        return NULL;
+
+    PyObject *prototype = transliteratorCache.lookup(key);
+
+    if (prototype == NULL)
+    {
+        UErrorCode status = U_ZERO_ERROR;
+        Transliterator *transliterator =
+            Transliterator::createInstance(id, direction, status);
+
+        if (U_FAILURE(status))
+        {
+            Py_DECREF(key);
+            return ICUException(status).reportError();
+        }
+
+        prototype = cachePrototype(key, transliterator);
+    }
+    Py_DECREF(key);
+
+    return clonePrototype(prototype);
+}
+
+static PyObject *createFromRules(const UnicodeString &id,
+                                 const UnicodeString &rules,
+                                 UTransDirection direction)
+{
+    PyObject *key = Py_BuildValue("(NNi)", PyUnicode_FromUnicodeString(&id),
+                                  PyUnicode_FromUnicodeString(&rules),
+                                  (int) direction);
+
+    if (key == NULL)
+        return NULL;
+
+    PyObject *prototype = transliteratorCache.lookup(key);
+
+    if (prototype == NULL)
+    {
+        UErrorCode status = U_ZERO_ERROR;
+        UParseError parseError;
+        Transliterator *transliterator = Transliterator::createFromRules(
+            id, rules, direction, parseError, status);
+
+        if (U_FAILURE(status))
+        {
+            Py_DECREF(key);
+            return ICUException(parseError, status).reportError();
+        }
+
+        prototype = cachePrototype(key, transliterator);
+    }
+    Py_DECREF(key);
+
+    return clonePrototype(prototype);
+}
+
 static PyObject *t_transliterator_createInstance(PyTypeObject *type,
                                                  PyObject *args)
 {
-    Transliterator *transliterator;
     UnicodeString *u, _u;
     UTransDirection direction = UTRANS_FORWARD;
 
     switch (PyTuple_Size(args)) {
       case 1:
         if (!parseArgs(args, "S", &u, &_u))
-        {
-            STATUS_CALL(transliterator = Transliterator::createInstance(
-                *u, direction, status));
-            return wrap_Transliterator(transliterator);
-        }
+            return createInstance(*u, direction);
         break;
       case 2:
         if (!parseArgs(args, "Si", &u, &_u, &direction))
-        {
-            STATUS_CALL(transliterator = Transliterator::createInstance(
-                *u, direction, status));
-            return wrap_Transliterator(transliterator);
-        }
+            return createInstance(*u, direction);
         break;
     }
 
@@ -675,7 +1142,6 @@ static PyObject *t_transliterator_createInstance(PyTypeObject *type,
 static PyObject *t_transliterator_createFromRules(PyTypeObject *type,
                                                   PyObject *args)
 {
-    Transliterator *transliterator;
     UnicodeString *u0, _u0;
     UnicodeString *u1, _u1;
     UTransDirection direction = UTRANS_FORWARD;
@@ -683,19 +1149,11 @@ static PyObject *t_transliterator_createFromRules(PyTypeObject *type,
     switch (PyTuple_Size(args)) {
       case 2:
         if (!parseArgs(args, "SS", &u0, &_u0, &u1, &_u1))
-        {
-            STATUS_PARSER_CALL(transliterator = Transliterator::createFromRules(
-                *u0, *u1, direction, parseError, status));
-            return wrap_Transliterator(transliterator);
-        }
+            return createFromRules(*u0, *u1, direction);
         break;
       case 3:
         if (!parseArgs(args, "SSi", &u0, &_u0, &u1, &_u1, &direction))
-        {
-            STATUS_PARSER_CALL(transliterator = Transliterator::createFromRules(
-                *u0, *u1, direction, parseError, status));
-            return wrap_Transliterator(transliterator);
-        }
+            return createFromRules(*u0, *u1, direction);
         break;
     }
 
@@ -710,12 +1168,41 @@ static PyObject *t_transliterator_registerInstance(PyTypeObject *type,
     if (!parseArgs(args, "P", TYPE_CLASSID(Transliterator), &transliterator))
     {
         Transliterator::registerInstance(transliterator->clone());
+
+        // the id may now refer to another transliterator
+        transliteratorCache.clear();
+
         Py_RETURN_NONE;
     }
 
     return PyErr_SetArgsError(type, "registerInstance", args);
 }
 
+static PyObject *t_transliterator_getCacheInfo(PyTypeObject *type)
+{
+    return transliteratorCache.getInfo();
+}
+
+static PyObject *t_transliterator_setCacheSize(PyTypeObject *type,
+                                               PyObject *arg)
+{
+    int capacity;
+
+    if (!parseArg(arg, "i", &capacity) && capacity >= 0)
+    {
+        transliteratorCache.setCapacity(capacity);
+        Py_RETURN_NONE;
+    }
+
+    return PyErr_SetArgsError(type, "setCacheSize", arg);
+}
+
+static PyObject *t_transliterator_clearCache(PyTypeObject *type)
+{
+    transliteratorCache.clear();
+    Py_RETURN_NONE;
+}
+
 static PyObject *t_transliterator_str(t_transliterator *self)
 {
     UnicodeString _u = self->object->getID();
@@ -725,6 +1212,14 @@ static PyObject *t_transliterator_str(t_transliterator *self)
 
 void _init_transliterator(PyObject *m)
 {
+#if PY_MAJOR_VERSION >= 3
+    handleTransliterate_NAME = PyUnicode_InternFromString("handleTransliterate");
+    transliterateRun_NAME = PyUnicode_InternFromString("transliterateRun");
+#else
+    handleTransliterate_NAME = PyString_InternFromString("handleTransliterate");
+    transliterateRun_NAME = PyString_InternFromString("transliterateRun");
+#endif
+
     TransliteratorType_.tp_str = (reprfunc) t_transliterator_str;
     UTransPositionType_.tp_getset = t_utransposition_properties;
 
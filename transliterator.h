@@ -27,6 +27,7 @@
 class t_transliterator : public _wrapper {
 public:
     Transliterator *object;
+    ObjectLock lock;
 };
 
 
@@ -35,6 +36,14 @@ U_NAMESPACE_BEGIN
 class U_EXPORT PythonTransliterator : public Transliterator {
   protected:
     t_transliterator *self;
+    bool wholeRun;  // self implements transliterateRun(str)
+
+    // wrappers passed to handleTransliterate(), reused between calls
+    mutable PyObject *textWrapper;
+    mutable PyObject *posWrapper;
+
+    void init();
+    void transliterateRun(Replaceable& text, UTransPosition& pos) const;
 
   public:
     /**
@@ -57,31 +57,50 @@ DECLARE_TYPE(StringTrieBuilder, t_stringtriebuilder, UObject,
 class t_bytestriebuilder : public _wrapper {
 public:
     BytesTrieBuilder *object;
+    ObjectLock lock;  /* held while building without the GIL */
+    int32_t count;    /* of entries added since cleared */
 };
 
 static int t_bytestriebuilder_init(
     t_bytestriebuilder *self, PyObject *args, PyObject *kwds);
 static PyObject *t_bytestriebuilder_add(
     t_bytestriebuilder *self, PyObject *args);
+static PyObject *t_bytestriebuilder_addAll(
+    t_bytestriebuilder *self, PyObject *arg);
 static PyObject *t_bytestriebuilder_clear(t_bytestriebuilder *self);
 static PyObject *t_bytestriebuilder_build(
     t_bytestriebuilder *self, PyObject *arg);
+static PyObject *t_bytestriebuilder_buildSerialized(
+    t_bytestriebuilder *self, PyObject *arg);
 
 static PyMethodDef t_bytestriebuilder_methods[] = {
     DECLARE_METHOD(t_bytestriebuilder, add, METH_VARARGS),
+    DECLARE_METHOD(t_bytestriebuilder, addAll, METH_O),
     DECLARE_METHOD(t_bytestriebuilder, clear, METH_NOARGS),
     DECLARE_METHOD(t_bytestriebuilder, build, METH_O),
+    DECLARE_METHOD(t_bytestriebuilder, buildSerialized, METH_O),
     { NULL, NULL, 0, NULL }
 };
 
+static void t_bytestriebuilder_dealloc(t_bytestriebuilder *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(BytesTrieBuilder, t_bytestriebuilder, StringTrieBuilder,
-             BytesTrieBuilder, t_bytestriebuilder_init, NULL)
+             BytesTrieBuilder, t_bytestriebuilder_init, t_bytestriebuilder_dealloc)
 
 /* BytesTrieIterator */
 
 class t_bytestrieiterator : public _wrapper {
 public:
     BytesTrieIterator *object;
+    PyObject *trie;  /* whose data object iterates */
 };
 
 int t_bytestrieiterator_init(
@@ -101,8 +120,18 @@ static PyMethodDef t_bytestrieiterator_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
+static void t_bytestrieiterator_dealloc(t_bytestrieiterator *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    Py_CLEAR(self->trie);
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(BytesTrieIterator, t_bytestrieiterator, UMemory,
-             BytesTrieIterator, t_bytestrieiterator_init, NULL)
+             BytesTrieIterator, t_bytestrieiterator_init, t_bytestrieiterator_dealloc)
 
 /* BytesTrieState */
 
@@ -123,8 +152,10 @@ DECLARE_TYPE(BytesTrieState, t_bytestriestate, UMemory,
 class t_bytestrie : public _wrapper {
 public:
     BytesTrie *object;
+    Py_buffer view;  /* aliased by object when loaded from a buffer */
 };
 
+static int t_bytestrie_init(t_bytestrie *self, PyObject *args, PyObject *kwds);
 static PyObject *t_bytestrie_reset(t_bytestrie *self);
 static PyObject *t_bytestrie_saveState(t_bytestrie *self);
 static PyObject *t_bytestrie_resetToState(t_bytestrie *self, PyObject *arg);
@@ -148,38 +179,69 @@ static PyMethodDef t_bytestrie_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
-DECLARE_TYPE(BytesTrie, t_bytestrie, UMemory, BytesTrie, abstract_init, NULL)
+static void t_bytestrie_dealloc(t_bytestrie *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    if (self->view.obj != NULL)
+        PyBuffer_Release(&self->view);
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+DECLARE_TYPE(BytesTrie, t_bytestrie, UMemory, BytesTrie,
+             t_bytestrie_init, t_bytestrie_dealloc)
 
 /* UCharsTrieBuilder */
 
 class t_ucharstriebuilder : public _wrapper {
 public:
     UCharsTrieBuilder *object;
+    ObjectLock lock;  /* held while building without the GIL */
+    int32_t count;    /* of entries added since cleared */
 };
 
 static int t_ucharstriebuilder_init(
     t_ucharstriebuilder *self, PyObject *args, PyObject *kwds);
 static PyObject *t_ucharstriebuilder_add(
     t_ucharstriebuilder *self, PyObject *args);
+static PyObject *t_ucharstriebuilder_addAll(
+    t_ucharstriebuilder *self, PyObject *arg);
 static PyObject *t_ucharstriebuilder_clear(t_ucharstriebuilder *self);
 static PyObject *t_ucharstriebuilder_build(
     t_ucharstriebuilder *self, PyObject *arg);
+static PyObject *t_ucharstriebuilder_buildSerialized(
+    t_ucharstriebuilder *self, PyObject *arg);
 
 static PyMethodDef t_ucharstriebuilder_methods[] = {
     DECLARE_METHOD(t_ucharstriebuilder, add, METH_VARARGS),
+    DECLARE_METHOD(t_ucharstriebuilder, addAll, METH_O),
     DECLARE_METHOD(t_ucharstriebuilder, clear, METH_NOARGS),
     DECLARE_METHOD(t_ucharstriebuilder, build, METH_O),
+    DECLARE_METHOD(t_ucharstriebuilder, buildSerialized, METH_O),
     { NULL, NULL, 0, NULL }
 };
 
+static void t_ucharstriebuilder_dealloc(t_ucharstriebuilder *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    self->lock.free();
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(UCharsTrieBuilder, t_ucharstriebuilder, StringTrieBuilder,
-             UCharsTrieBuilder, t_ucharstriebuilder_init, NULL)
+             UCharsTrieBuilder, t_ucharstriebuilder_init, t_ucharstriebuilder_dealloc)
 
 /* UCharsTrieIterator */
 
 class t_ucharstrieiterator : public _wrapper {
 public:
     UCharsTrieIterator *object;
+    PyObject *trie;  /* whose data object iterates */
 };
 
 int t_ucharstrieiterator_init(
@@ -199,8 +261,18 @@ static PyMethodDef t_ucharstrieiterator_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
+static void t_ucharstrieiterator_dealloc(t_ucharstrieiterator *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    Py_CLEAR(self->trie);
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(UCharsTrieIterator, t_ucharstrieiterator, UMemory,
-             UCharsTrieIterator, t_ucharstrieiterator_init, NULL)
+             UCharsTrieIterator, t_ucharstrieiterator_init, t_ucharstrieiterator_dealloc)
 
 /* UCharsTrieState */
 
@@ -221,8 +293,10 @@ DECLARE_TYPE(UCharsTrieState, t_ucharstriestate, UMemory,
 class t_ucharstrie : public _wrapper {
 public:
     UCharsTrie *object;
+    Py_buffer view;  /* aliased by object when loaded from a buffer */
 };
 
+static int t_ucharstrie_init(t_ucharstrie *self, PyObject *args, PyObject *kwds);
 static PyObject *t_ucharstrie_reset(t_ucharstrie *self);
 static PyObject *t_ucharstrie_saveState(t_ucharstrie *self);
 static PyObject *t_ucharstrie_resetToState(t_ucharstrie *self, PyObject *arg);
@@ -250,8 +324,19 @@ static PyMethodDef t_ucharstrie_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
+static void t_ucharstrie_dealloc(t_ucharstrie *self)
+{
+    if (self->flags & T_OWNED)
+        delete self->object;
+    self->object = NULL;
+    if (self->view.obj != NULL)
+        PyBuffer_Release(&self->view);
+
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
 DECLARE_TYPE(UCharsTrie, t_ucharstrie, UMemory,
-             UCharsTrie, abstract_init, NULL)
+             UCharsTrie, t_ucharstrie_init, t_ucharstrie_dealloc)
 
 /* BytesTrieBuilder */
 
@@ -278,6 +363,90 @@ static int t_bytestriebuilder_init(t_bytestriebuilder *self, PyObject *args,
     return -1;
 }
 
+/* Calls add(self, key, value) for each entry of a dict, of another
+ * mapping's items() or of an iterable of (key, value) pairs, in one loop
+ * without parseArgs(). Entries added before an error are kept.
+ */
+static int addEntries(PyObject *self, PyObject *entries,
+                      int (*add)(PyObject *, PyObject *, int32_t))
+{
+    PyObject *key, *value;
+
+    if (PyDict_Check(entries))
+    {
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next(entries, &pos, &key, &value)) {
+            long n = PyInt_AsLong(value);
+
+            if (n == -1 && PyErr_Occurred())
+                return -1;
+            if (n < INT32_MIN || n > INT32_MAX)
+            {
+                PyErr_SetObject(PyExc_OverflowError, value);
+                return -1;
+            }
+            if (add(self, key, (int32_t) n) < 0)
+                return -1;
+        }
+
+        return 0;
+    }
+
+    PyObject *iterator;
+
+    if (PyObject_HasAttrString(entries, "items"))
+    {
+        PyObject *items = PyObject_CallMethod(entries, (char *) "items", NULL);
+
+        if (items == NULL)
+            return -1;
+
+        iterator = PyObject_GetIter(items);
+        Py_DECREF(items);
+    }
+    else
+        iterator = PyObject_GetIter(entries);
+
+    if (iterator == NULL)
+        return -1;
+
+    PyObject *item;
+
+    while ((item = PyIter_Next(iterator)) != NULL) {
+        PyObject *pair = PySequence_Fast(item, "entries must be pairs");
+        int result = -1;
+
+        Py_DECREF(item);
+        if (pair == NULL)
+            break;
+
+        if (PySequence_Fast_GET_SIZE(pair) != 2)
+            PyErr_SetString(PyExc_ValueError, "entries must be pairs");
+        else
+        {
+            key = PySequence_Fast_GET_ITEM(pair, 0);
+            value = PySequence_Fast_GET_ITEM(pair, 1);
+
+            long n = PyInt_AsLong(value);
+
+            if (n == -1 && PyErr_Occurred())
+                result = -1;
+            else if (n < INT32_MIN || n > INT32_MAX)
+                PyErr_SetObject(PyExc_OverflowError, value);
+            else
+                result = add(self, key, (int32_t) n);
+        }
+        Py_DECREF(pair);
+
+        if (result < 0)
+            break;
+    }
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? -1 : 0;
+}
+
 static PyObject *t_bytestriebuilder_add(
     t_bytestriebuilder *self, PyObject *args)
 {
@@ -286,16 +455,82 @@ static PyObject *t_bytestriebuilder_add(
 
     if (!parseArgs(args, "ni", &key, &value))
     {
+        ObjectLocker locker(self->lock);
+
         STATUS_CALL(self->object->add(key.c_str(), value, status));
+        self->count += 1;
+
         Py_RETURN_SELF();
     }
 
     return PyErr_SetArgsError((PyObject *) self, "add", args);
 }
 
+/* bytes keys are added as is, str keys UTF-8 encoded like with add() */
+static int addBytesEntry(PyObject *object, PyObject *key, int32_t value)
+{
+    t_bytestriebuilder *self = (t_bytestriebuilder *) object;
+    UErrorCode status = U_ZERO_ERROR;
+
+    if (PyBytes_Check(key))
+        self->object->add(StringPiece(PyBytes_AS_STRING(key),
+                                      (int32_t) PyBytes_GET_SIZE(key)),
+                          value, status);
+#if PY_VERSION_HEX >= 0x03030000 && !defined(PYPY_VERSION)
+    else if (PyUnicode_Check(key) && PyUnicode_READY(key) == 0 &&
+             PyUnicode_IS_ASCII(key))
+        self->object->add(StringPiece((const char *) PyUnicode_DATA(key),
+                                      (int32_t) PyUnicode_GET_LENGTH(key)),
+                          value, status);
+#endif
+    else if (PyUnicode_Check(key))
+    {
+        PyObject *bytes = PyUnicode_AsUTF8String(key);
+
+        if (bytes == NULL)
+            return -1;
+
+        self->object->add(StringPiece(PyBytes_AS_STRING(bytes),
+                                      (int32_t) PyBytes_GET_SIZE(bytes)),
+                          value, status);
+        Py_DECREF(bytes);
+    }
+    else
+    {
+        PyErr_Format(PyExc_TypeError, "key must be bytes or str, not %s",
+                     Py_TYPE(key)->tp_name);
+        return -1;
+    }
+
+    if (U_FAILURE(status))
+    {
+        ICUException(status).reportError();
+        return -1;
+    }
+
+    self->count += 1;
+
+    return 0;
+}
+
+static PyObject *t_bytestriebuilder_addAll(
+    t_bytestriebuilder *self, PyObject *arg)
+{
+    ObjectLocker locker(self->lock);
+
+    if (addEntries((PyObject *) self, arg, addBytesEntry) < 0)
+        return NULL;
+
+    Py_RETURN_SELF();
+}
+
 static PyObject *t_bytestriebuilder_clear(t_bytestriebuilder *self)
 {
+    ObjectLocker locker(self->lock);
+
     self->object->clear();
+    self->count = 0;
+
     Py_RETURN_SELF();
 }
 
@@ -306,11 +541,15 @@ static PyObject *t_bytestriebuilder_build(
 
     if (!parseArg(arg, "i", &option))
     {
+        ObjectLocker locker(self->lock);
         BytesTrie *trie;
 
-        STATUS_CALL(trie = self->object->build(
-            (UStringTrieBuildOption) option, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self->count),
+            trie = self->object->build(
+                (UStringTrieBuildOption) option, status));
         self->object->clear();  // builder data is now owned by trie
+        self->count = 0;
 
         return wrap_BytesTrie(trie, T_OWNED);
     }
@@ -318,9 +557,110 @@ static PyObject *t_bytestriebuilder_build(
     return PyErr_SetArgsError((PyObject *) self, "build", arg);
 }
 
+static PyObject *t_bytestriebuilder_buildSerialized(
+    t_bytestriebuilder *self, PyObject *arg)
+{
+    int option;
+
+    if (!parseArg(arg, "i", &option))
+    {
+        ObjectLocker locker(self->lock);
+        StringPiece bytes;
+
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self->count),
+            bytes = self->object->buildStringPiece(
+                (UStringTrieBuildOption) option, status));
+
+        PyObject *result = PyBytes_FromStringAndSize(
+            bytes.data(), bytes.size());
+
+        self->object->clear();  // like build()
+        self->count = 0;
+
+        return result;
+    }
+
+    return PyErr_SetArgsError((PyObject *) self, "buildSerialized", arg);
+}
+
 
 /* BytesTrie */
 
+/* Gets a read-only view of the serialized trie in data, of a copy of it if
+ * the buffer is writable. Tries are not validated by ICU, the data must come
+ * from buildSerialized().
+ */
+static int getTrieData(PyObject *data, Py_buffer *view, size_t unitSize)
+{
+    if (PyObject_GetBuffer(data, view, PyBUF_SIMPLE) < 0)
+        return -1;
+
+    if (!view->readonly)
+    {
+        PyObject *copy = PyBytes_FromStringAndSize((const char *) view->buf,
+                                                   view->len);
+
+        PyBuffer_Release(view);
+        if (copy == NULL)
+            return -1;
+
+        int result = PyObject_GetBuffer(copy, view, PyBUF_SIMPLE);
+
+        Py_DECREF(copy);
+        if (result < 0)
+            return -1;
+    }
+
+    if (view->len < (Py_ssize_t) unitSize ||
+        view->len % unitSize != 0 ||
+        (size_t) view->buf % unitSize != 0)
+    {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_ValueError, "invalid serialized trie data");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int t_bytestrie_init(t_bytestrie *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *data;
+
+    // iterators alias the data of the trie, it can't be replaced
+    if (self->object != NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "BytesTrie already initialized");
+        return -1;
+    }
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "K", &data) && PyObject_CheckBuffer(data))
+        {
+            if (getTrieData(data, &self->view, 1) < 0)
+                return -1;
+
+            // the trie aliases the buffer, which is kept until dealloc
+            self->object = new BytesTrie(self->view.buf);
+            self->flags = T_OWNED;
+            break;
+        }
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+
+      default:
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+    }
+
+    if (self->object)
+        return 0;
+
+    return -1;
+}
+
 static PyObject *t_bytestrie_reset(t_bytestrie *self)
 {
     self->object->reset();
@@ -353,7 +693,15 @@ static PyObject *t_bytestrie_iter(t_bytestrie *self)
     BytesTrieIterator *iter;
     STATUS_CALL(iter = new BytesTrieIterator(*self->object, 0, status));
 
-    return wrap_BytesTrieIterator(iter, T_OWNED);
+    PyObject *result = wrap_BytesTrieIterator(iter, T_OWNED);
+
+    if (result != NULL)
+    {
+        Py_INCREF(self);
+        ((t_bytestrieiterator *) result)->trie = (PyObject *) self;
+    }
+
+    return result;
 }
 
 static PyObject *t_bytestrie_current(t_bytestrie *self)
@@ -441,6 +789,9 @@ int t_bytestrieiterator_init(t_bytestrieiterator *self,
                 *((t_bytestrie *) trie)->object, 0, status));
             self->object = iterator;
             self->flags = T_OWNED;
+            Py_INCREF(trie);
+            Py_XDECREF(self->trie);
+            self->trie = trie;
         }
         else
             PyErr_SetArgsError((PyObject *) self, "__init__", args);
@@ -453,6 +804,9 @@ int t_bytestrieiterator_init(t_bytestrieiterator *self,
                 *((t_bytestrie *) trie)->object, len, status));
             self->object = iterator;
             self->flags = T_OWNED;
+            Py_INCREF(trie);
+            Py_XDECREF(self->trie);
+            self->trie = trie;
         }
         else
             PyErr_SetArgsError((PyObject *) self, "__init__", args);
@@ -563,16 +917,76 @@ static PyObject *t_ucharstriebuilder_add(
 
     if (!parseArgs(args, "Si", &u, &_u, &value))
     {
+        ObjectLocker locker(self->lock);
+
         STATUS_CALL(self->object->add(*u, value, status));
+        self->count += 1;
+
         Py_RETURN_SELF();
     }
 
     return PyErr_SetArgsError((PyObject *) self, "add", args);
 }
 
+/* str keys stored as UTF-16 are aliased, bytes keys UTF-8 decoded */
+static int addUCharsEntry(PyObject *object, PyObject *key, int32_t value)
+{
+    t_ucharstriebuilder *self = (t_ucharstriebuilder *) object;
+    UErrorCode status = U_ZERO_ERROR;
+
+    if (isUnicodeString(key))
+        self->object->add(*(UnicodeString *) ((t_uobject *) key)->object,
+                          value, status);
+    else if (PyUnicode_Check(key) || PyBytes_Check(key))
+    {
+        UnicodeString u;
+
+        try {
+            PyObject_AsUnicodeStringAlias(key, u);
+        } catch (ICUException e) {
+            e.reportError();
+            return -1;
+        }
+
+        self->object->add(u, value, status);
+    }
+    else
+    {
+        PyErr_Format(PyExc_TypeError,
+                     "key must be str, bytes or UnicodeString, not %s",
+                     Py_TYPE(key)->tp_name);
+        return -1;
+    }
+
+    if (U_FAILURE(status))
+    {
+        ICUException(status).reportError();
+        return -1;
+    }
+
+    self->count += 1;
+
+    return 0;
+}
+
+static PyObject *t_ucharstriebuilder_addAll(
+    t_ucharstriebuilder *self, PyObject *arg)
+{
+    ObjectLocker locker(self->lock);
+
+    if (addEntries((PyObject *) self, arg, addUCharsEntry) < 0)
+        return NULL;
+
+    Py_RETURN_SELF();
+}
+
 static PyObject *t_ucharstriebuilder_clear(t_ucharstriebuilder *self)
 {
+    ObjectLocker locker(self->lock);
+
     self->object->clear();
+    self->count = 0;
+
     Py_RETURN_SELF();
 }
 
@@ -583,11 +997,15 @@ static PyObject *t_ucharstriebuilder_build(
 
     if (!parseArg(arg, "i", &option))
     {
+        ObjectLocker locker(self->lock);
         UCharsTrie *trie;
 
-        STATUS_CALL(trie = self->object->build(
-            (UStringTrieBuildOption) option, status));
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self->count),
+            trie = self->object->build(
+                (UStringTrieBuildOption) option, status));
         self->object->clear();  // builder data is now owned by trie
+        self->count = 0;
 
         return wrap_UCharsTrie(trie, T_OWNED);
     }
@@ -595,8 +1013,74 @@ static PyObject *t_ucharstriebuilder_build(
     return PyErr_SetArgsError((PyObject *) self, "build", arg);
 }
 
+static PyObject *t_ucharstriebuilder_buildSerialized(
+    t_ucharstriebuilder *self, PyObject *arg)
+{
+    int option;
+
+    if (!parseArg(arg, "i", &option))
+    {
+        ObjectLocker locker(self->lock);
+        UnicodeString u;
+
+        STATUS_ALLOW_THREADS_CALL(
+            allowThreads(self->count),
+            self->object->buildUnicodeString(
+                (UStringTrieBuildOption) option, u, status));
+
+        // the UChars in native byte order, as UCharsTrie(buffer) reads them
+        PyObject *result = PyBytes_FromStringAndSize(
+            (const char *) u.getBuffer(), u.length() * sizeof(UChar));
+
+        self->object->clear();  // like build()
+        self->count = 0;
+
+        return result;
+    }
+
+    return PyErr_SetArgsError((PyObject *) self, "buildSerialized", arg);
+}
+
 /* UCharsTrie */
 
+static int t_ucharstrie_init(t_ucharstrie *self,
+                             PyObject *args, PyObject *kwds)
+{
+    PyObject *data;
+
+    // iterators alias the data of the trie, it can't be replaced
+    if (self->object != NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "UCharsTrie already initialized");
+        return -1;
+    }
+
+    switch (PyTuple_Size(args)) {
+      case 1:
+        if (!parseArgs(args, "K", &data) && PyObject_CheckBuffer(data))
+        {
+            if (getTrieData(data, &self->view, sizeof(UChar)) < 0)
+                return -1;
+
+            // the trie aliases the buffer, which is kept until dealloc
+            self->object = new UCharsTrie((const UChar *) self->view.buf);
+            self->flags = T_OWNED;
+            break;
+        }
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+
+      default:
+        PyErr_SetArgsError((PyObject *) self, "__init__", args);
+        return -1;
+    }
+
+    if (self->object)
+        return 0;
+
+    return -1;
+}
+
 static PyObject *t_ucharstrie_reset(t_ucharstrie *self)
 {
     self->object->reset();
@@ -629,7 +1113,15 @@ static PyObject *t_ucharstrie_iter(t_ucharstrie *self)
     UCharsTrieIterator *iter;
     STATUS_CALL(iter = new UCharsTrieIterator(*self->object, 0, status));
 
-    return wrap_UCharsTrieIterator(iter, T_OWNED);
+    PyObject *result = wrap_UCharsTrieIterator(iter, T_OWNED);
+
+    if (result != NULL)
+    {
+        Py_INCREF(self);
+        ((t_ucharstrieiterator *) result)->trie = (PyObject *) self;
+    }
+
+    return result;
 }
 
 static PyObject *t_ucharstrie_current(t_ucharstrie *self)
@@ -740,6 +1232,9 @@ int t_ucharstrieiterator_init(t_ucharstrieiterator *self,
                 *((t_ucharstrie *) trie)->object, 0, status));
             self->object = iterator;
             self->flags = T_OWNED;
+            Py_INCREF(trie);
+            Py_XDECREF(self->trie);
+            self->trie = trie;
         }
         else
             PyErr_SetArgsError((PyObject *) self, "__init__", args);
@@ -752,6 +1247,9 @@ int t_ucharstrieiterator_init(t_ucharstrieiterator *self,
                 *((t_ucharstrie *) trie)->object, len, status));
             self->object = iterator;
             self->flags = T_OWNED;
+            Py_INCREF(trie);
+            Py_XDECREF(self->trie);
+            self->trie = trie;
         }
         else
             PyErr_SetArgsError((PyObject *) self, "__init__", args);
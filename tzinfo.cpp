@@ -38,10 +38,13 @@ typedef PyObject PyDateTime_TZInfo;
 
 /* A tzinfo extension that wraps an ICU timezone wrapper.
  * The tz field is supposed to be immutable.
+ * The transitions field caches the zone's offsets, it is NULL for zones
+ * that could be modified, such as a SimpleTimeZone.
  */
 typedef struct {
     PyDateTime_TZInfo dt_tzinfo;
     t_timezone *tz;
+    TransitionTable *transitions;
 } t_tzinfo;
 
 /* A tzinfo extension that wraps an ICU tzinfo wrapper.
@@ -82,8 +85,18 @@ static PyObject *_instances;
 static t_tzinfo *_default, *_floating;
 static PyTypeObject *datetime_tzinfoType, *datetime_deltaType;
 static PyObject *FLOATING_TZNAME;
-static PyObject *toordinal_NAME;
-static PyObject *weekday_NAME;
+
+/* timedelta objects are immutable, the ones for the few distinct offsets
+ * in use are shared instead of being created for each call.
+ */
+#define DELTA_CACHE_SIZE 64
+static struct {
+    int seconds;
+    PyObject *delta;
+} deltaCache[DELTA_CACHE_SIZE];
+
+/* transition tables grow by blocks of TRANSITION_YEARS years as needed */
+#define TRANSITION_YEARS 16
 
 
 static PyMethodDef t_tzinfo_methods[] = {
@@ -237,6 +250,8 @@ PyTypeObject FloatingTZType_ = {
 static void t_tzinfo_dealloc(t_tzinfo *self)
 {
     Py_CLEAR(self->tz);
+    delete self->transitions;
+    self->transitions = NULL;
     Py_TYPE(&self->dt_tzinfo)->tp_free((PyObject *) self);
 }
 
@@ -252,7 +267,10 @@ static PyObject *t_tzinfo_new(PyTypeObject *type,
     t_tzinfo *tzinfo = (t_tzinfo *) type->tp_alloc(type, 0);
 
     if (tzinfo)
+    {
         tzinfo->tz = NULL;
+        tzinfo->transitions = NULL;
+    }
 
     return (PyObject *) tzinfo;
 }
@@ -285,6 +303,17 @@ static int t_tzinfo_init(t_tzinfo *self, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->tz);
     self->tz = (t_timezone *) tz;
 
+    TimeZone *object = self->tz->object;
+
+    delete self->transitions;
+    if (ISINSTANCE(object, SimpleTimeZone) ||
+        ISINSTANCE(object, RuleBasedTimeZone) ||
+        ISINSTANCE(object, VTimeZone) ||
+        dynamic_cast<BasicTimeZone *>(object) == NULL)
+        self->transitions = NULL;
+    else
+        self->transitions = new TransitionTable();
+
     return 0;
 }
 
@@ -546,30 +575,104 @@ static PyObject *t_tzinfo_getInstance(PyTypeObject *cls, PyObject *id)
 
 static double _udate(PyObject *dt)
 {
-    PyObject *result = PyObject_CallMethodObjArgs(dt, toordinal_NAME, NULL);
-
-    if (!result)
+    if (!PyDateTime_Check(dt))
+    {
+        PyErr_SetObject(PyExc_TypeError, dt);
         return 0.0;
+    }
 
-#if PY_MAJOR_VERSION >= 3
-    unsigned long ordinal = PyLong_AsUnsignedLong(result);
-#else
-    unsigned long ordinal = PyInt_AS_LONG(result);
-#endif
-
-    Py_DECREF(result);
-    return ((ordinal - 719163) * 86400.0 +
+    return (daysFromCivil(PyDateTime_GET_YEAR(dt), PyDateTime_GET_MONTH(dt),
+                          PyDateTime_GET_DAY(dt)) * 86400.0 +
             PyDateTime_DATE_GET_HOUR(dt) * 3600.0 +
             PyDateTime_DATE_GET_MINUTE(dt) * 60.0 +
             PyDateTime_DATE_GET_SECOND(dt) +
             PyDateTime_DATE_GET_MICROSECOND(dt) / 1e6) * 1000.0;
 }
 
-static PyObject *t_tzinfo_utcoffset(t_tzinfo *self, PyObject *dt)
+static PyObject *_delta(int seconds)
 {
-    PyObject *weekday = PyObject_CallMethodObjArgs(dt, weekday_NAME, NULL);
-    if (!weekday)
-        return NULL;
+    int i = ((seconds / 60) % DELTA_CACHE_SIZE + DELTA_CACHE_SIZE) %
+        DELTA_CACHE_SIZE;
+
+    if (deltaCache[i].delta == NULL || deltaCache[i].seconds != seconds)
+    {
+        PyObject *args = PyTuple_New(2);
+        PyObject *delta;
+
+        PyTuple_SET_ITEM(args, 0, PyInt_FromLong(0));
+        PyTuple_SET_ITEM(args, 1, PyInt_FromLong(seconds));
+        delta = PyObject_Call((PyObject *) datetime_deltaType, args, NULL);
+        Py_DECREF(args);
+
+        if (delta == NULL)
+            return NULL;
+
+        Py_XDECREF(deltaCache[i].delta);
+        deltaCache[i].delta = delta;
+        deltaCache[i].seconds = seconds;
+    }
+
+    Py_INCREF(deltaCache[i].delta);
+    return deltaCache[i].delta;
+}
+
+/* Looks up the offsets of a local time in the zone's transition table,
+ * which is built or extended when the year isn't covered yet. Returns false
+ * when the answer must come from the zone itself.
+ */
+static bool _getCachedOffset(t_tzinfo *self, int year, UDate local,
+                             int32_t &raw, int32_t &dst)
+{
+    TransitionTable *table = self->transitions;
+
+    if (table == NULL)
+        return false;
+
+    if (table->getLocalOffset(local, raw, dst))
+        return true;
+
+    if (table->count > 0 &&
+        local >= table->start + U_MILLIS_PER_DAY &&
+        local < table->limit - U_MILLIS_PER_DAY)
+        return false;  /* skipped or repeated local time */
+
+    if (year < TRANSITION_MIN_YEAR || year >= TRANSITION_MAX_YEAR)
+        return false;
+
+    int first = year - (year - TRANSITION_MIN_YEAR) % TRANSITION_YEARS;
+    UDate start = daysFromCivil(first, 1, 1) * U_MILLIS_PER_DAY -
+        U_MILLIS_PER_DAY;
+    UDate limit = daysFromCivil(first + TRANSITION_YEARS, 1, 1) *
+        U_MILLIS_PER_DAY + U_MILLIS_PER_DAY;
+    UErrorCode status = U_ZERO_ERROR;
+
+    if (table->count > 0)
+    {
+        if (table->start < start)
+            start = table->start;
+        if (table->limit > limit)
+            limit = table->limit;
+    }
+
+    if (!table->build(self->tz->object, start, limit, status) ||
+        U_FAILURE(status))
+    {
+        delete table;
+        self->transitions = NULL;
+
+        return false;
+    }
+
+    return table->getLocalOffset(local, raw, dst);
+}
+
+static int _getOffset(t_tzinfo *self, PyObject *dt, int *offset)
+{
+    if (!PyDateTime_Check(dt))
+    {
+        PyErr_SetObject(PyExc_TypeError, dt);
+        return -1;
+    }
 
     // python's MINYEAR is 1
     int era = GregorianCalendar::AD;
@@ -579,31 +682,76 @@ static PyObject *t_tzinfo_utcoffset(t_tzinfo *self, PyObject *dt)
     // ICU's month is 0-based, 0 is January
     int month = PyDateTime_GET_MONTH(dt) - 1;
     int day = PyDateTime_GET_DAY(dt);
-
-    // python's weekday is 0-based, 0 is Monday
-    // ICU's dayofweek is 1-based, 1 is Sunday
-    int dayofweek = ((PyInt_AsLong(weekday) + 1) % 7) + 1;
-    Py_DECREF(weekday);
+    int64_t days = daysFromCivil(year, month + 1, day);
 
     int millis = (int) ((PyDateTime_DATE_GET_HOUR(dt) * 3600.0 +
                          PyDateTime_DATE_GET_MINUTE(dt) * 60.0 +
                          PyDateTime_DATE_GET_SECOND(dt) +
                          PyDateTime_DATE_GET_MICROSECOND(dt) / 1e6) * 1000.0);
-    int offset;
+    int32_t raw, dst;
 
-    STATUS_CALL(offset = self->tz->object->getOffset(era, year, month, day,
-                                                     dayofweek, millis,
-                                                     status));
+    if (_getCachedOffset(self, year, days * U_MILLIS_PER_DAY + millis,
+                         raw, dst))
+    {
+        *offset = raw + dst;
+        return 0;
+    }
 
-    PyObject *args = PyTuple_New(2);
-    PyObject *result;
+    // ICU's dayofweek is 1-based, 1 is Sunday
+    // 1970-01-01 was a Thursday
+    int dayofweek = (int) (((days + 4) % 7 + 7) % 7) + 1;
+    UErrorCode status = U_ZERO_ERROR;
 
-    PyTuple_SET_ITEM(args, 0, PyInt_FromLong(0));
-    PyTuple_SET_ITEM(args, 1, PyInt_FromLong(offset / 1000));
-    result = PyObject_Call((PyObject *) datetime_deltaType, args, NULL);
-    Py_DECREF(args);
+    *offset = self->tz->object->getOffset(era, year, month, day,
+                                          dayofweek, millis, status);
+    if (U_FAILURE(status))
+    {
+        ICUException(status).reportError();
+        return -1;
+    }
 
-    return result;
+    return 0;
+}
+
+int t_tzinfo_getOffset(PyObject *dt, int *offset)
+{
+    t_tzinfo *tzinfo;
+
+#ifndef PYPY_VERSION
+    PyObject *obj = ((PyDateTime_DateTime *) dt)->hastzinfo
+        ? ((PyDateTime_DateTime *) dt)->tzinfo : Py_None;
+#else
+    PyObject *obj = PyObject_GetAttrString(dt, "tzinfo");
+
+    if (obj == NULL)
+        return -1;
+    Py_DECREF(obj);  // still referenced by dt
+#endif
+
+    if (obj == Py_None)
+        tzinfo = _default;
+    else if (Py_TYPE(obj) == &TZInfoType_)
+        tzinfo = (t_tzinfo *) obj;
+    else if (Py_TYPE(obj) == &FloatingTZType_)
+        tzinfo = ((t_floatingtz *) obj)->tzinfo
+            ? ((t_floatingtz *) obj)->tzinfo : _default;
+    else
+        return 0;
+
+    if (tzinfo == NULL)
+        return 0;
+
+    return _getOffset(tzinfo, dt, offset) ? -1 : 1;
+}
+
+static PyObject *t_tzinfo_utcoffset(t_tzinfo *self, PyObject *dt)
+{
+    int offset;
+
+    if (_getOffset(self, dt, &offset))
+        return NULL;
+
+    return _delta(offset / 1000);
 }
 
 static PyObject *t_tzinfo_dst(t_tzinfo *self, PyObject *dt)
@@ -614,17 +762,10 @@ static PyObject *t_tzinfo_dst(t_tzinfo *self, PyObject *dt)
     if (date == 0.0 && PyErr_Occurred())
         return NULL;
 
-    STATUS_CALL(self->tz->object->getOffset(date, 1, raw, dst, status));
-
-    PyObject *args = PyTuple_New(2);
-    PyObject *result;
-
-    PyTuple_SET_ITEM(args, 0, PyInt_FromLong(0));
-    PyTuple_SET_ITEM(args, 1, PyInt_FromLong(dst / 1000));
-    result = PyObject_Call((PyObject *) datetime_deltaType, args, NULL);
-    Py_DECREF(args);
+    if (!_getCachedOffset(self, PyDateTime_GET_YEAR(dt), date, raw, dst))
+        STATUS_CALL(self->tz->object->getOffset(date, 1, raw, dst, status));
 
-    return result;
+    return _delta(dst / 1000);
 }
 
 static PyObject *t_tzinfo_tzname(t_tzinfo *self, PyObject *dt)
@@ -711,8 +852,6 @@ void _init_tzinfo(PyObject *m)
             PyModule_AddObject(m, "FloatingTZ", (PyObject *) &FloatingTZType_);
 
             FLOATING_TZNAME = PyString_FromString("World/Floating");
-            toordinal_NAME = PyString_FromString("toordinal");
-            weekday_NAME = PyString_FromString("weekday");
 
             Py_INCREF(FLOATING_TZNAME);
             PyModule_AddObject(m, "FLOATING_TZNAME", FLOATING_TZNAME);
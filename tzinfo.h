@@ -26,4 +26,11 @@
 
 void _init_tzinfo(PyObject *m);
 
+/* Computes the UTC offset, in milliseconds, of a datetime whose tzinfo is
+ * an ICUtzinfo, a FloatingTZ or None, the default ICUtzinfo, without
+ * calling into python. Returns 1 when it did, 0 when the datetime has
+ * another tzinfo and -1 when an error was raised.
+ */
+int t_tzinfo_getOffset(PyObject *dt, int *offset);
+
 #endif /* _tzinfo_h */